@@ -0,0 +1,242 @@
+#include <benchmark/benchmark.h>
+#include "include/GameOfLife.h"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Набор воспроизводимых нагрузок для calculateNextState.
+// Запуск из корня репозитория (нужны каталоги templates/ и rules/), например:
+//   ./benchGame --benchmark_format=json --benchmark_out=bench.json
+// Дополнительные параметры:
+//   --max-size=N   — не запускать поля больше N x N (по умолчанию 16384)
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr unsigned kSeed = 20240601;
+
+// Случайный суп: каждая клетка жива с вероятностью 1/2, зерно зависит только от размера
+void fillSoup(Game& game) {
+    std::mt19937_64 gen(kSeed + game.numRows);
+    Grid::Word* words = game.field.data();
+    const int rowWords = game.field.wordsPerRow();
+    for (int row = 0; row < game.numRows; ++row) {
+        for (int word = 0; word < rowWords; ++word) {
+            words[static_cast<std::size_t>(row) * rowWords + word] = gen();
+        }
+        words[static_cast<std::size_t>(row) * rowWords + rowWords - 1] &= game.field.tailMask();
+    }
+}
+
+// Скорость в клетках и поколениях в секунду
+void reportRates(benchmark::State& state, const Game& game) {
+    double cells = static_cast<double>(game.numRows) * game.numCols;
+    state.counters["cells_per_second"] = benchmark::Counter(cells * state.iterations(), benchmark::Counter::kIsRate);
+    state.counters["generations_per_second"] = benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+    state.counters["active_tiles"] = static_cast<double>(game.activeTiles);
+}
+
+// Поле пересоздается каждые kReseedEvery поколений (вне замера), чтобы нагрузка не зависела от того,
+// сколько итераций выберет Google Benchmark: суп не успевает выгореть, а шаблон — разрастись
+constexpr long long kReseedEvery = 64;
+
+// tiles — отслеживание активных плиток: с ним и без него это разные серии замеров
+void benchSoup(benchmark::State& state, int size, std::string rule, int threads, bool tiles) {
+    Game game("Bench", size, size);
+    game.parseRules(rule);
+    game.setThreads(threads);
+    game.trackActivity = tiles;
+
+    long long generation = 0;
+    for (auto _ : state) {
+        if (generation++ % kReseedEvery == 0) {
+            state.PauseTiming();
+            fillSoup(game);
+            state.ResumeTiming();
+        }
+        game.calculateNextState();
+    }
+    reportRates(state, game);
+}
+
+void benchTemplate(benchmark::State& state, int size, std::string templateName, int threads, bool tiles) {
+    Game game("Bench", size, size);
+    game.setThreads(threads);
+    game.trackActivity = tiles;
+
+    long long generation = 0;
+    for (auto _ : state) {
+        if (generation++ % kReseedEvery == 0) {
+            state.PauseTiming();
+            game.field.clear();
+            game.loadTemplate(templateName, size / 2, size / 2);
+            state.ResumeTiming();
+        }
+        game.calculateNextState();
+    }
+    reportRates(state, game);
+}
+
+// Временная блокировка: один проход по полю продвигает его на steps поколений (steps = 1 — обычный
+// полный пересчет без отслеживания плиток). Скорость считается в поколениях, а не в проходах
+void benchBlocked(benchmark::State& state, int size, int steps, int threads) {
+    Game game("Bench", size, size);
+    game.trackActivity = false;
+    game.blockSteps = steps;
+    game.setThreads(threads);
+    fillSoup(game);
+
+    for (auto _ : state) {
+        game.advance(steps);
+    }
+    double cells = static_cast<double>(game.numRows) * game.numCols;
+    double generations = static_cast<double>(state.iterations()) * steps;
+    state.counters["cells_per_second"] = benchmark::Counter(cells * generations, benchmark::Counter::kIsRate);
+    state.counters["generations_per_second"] = benchmark::Counter(generations, benchmark::Counter::kIsRate);
+}
+
+// Правило Larger than Life радиуса range: диапазоны в тех же долях окрестности, что и у правила Bosco
+// (R5,C0,M1,S34..58,B34..45,NM), чтобы суп не вымирал и не заполнял поле при любом радиусе
+std::string rangeRule(int range, bool moore) {
+    const int cells = moore ? (2 * range + 1) * (2 * range + 1) : 2 * range * (range + 1) + 1;
+    auto share = [cells](int bosco) { return std::to_string(std::max(1, cells * bosco / 121)); };
+    return "R" + std::to_string(range) + ",C0,M1,S" + share(34) + ".." + share(58) + ",B" + share(34) + ".." +
+           share(45) + (moore ? ",NM" : ",NN");
+}
+
+// Имена файлов с расширением .txt из каталога, по алфавиту
+std::vector<std::string> listFiles(const std::string& directory) {
+    std::vector<std::string> files;
+    if (fs::exists(directory) && fs::is_directory(directory)) {
+        for (const auto& entry : fs::directory_iterator(directory)) {
+            if (entry.is_regular_file() && entry.path().extension() == ".txt") {
+                files.push_back(entry.path().filename().string());
+            }
+        }
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+// Правила из rules/ (пустые файлы пропускаются) и классическое B3/S23
+std::vector<std::string> loadRules() {
+    std::vector<std::string> rules = {"B3/S23"};
+    for (const std::string& file : listFiles("rules")) {
+        std::ifstream input("rules/" + file);
+        std::string rule;
+        if (std::getline(input, rule) && rule.find('/') != std::string::npos &&
+            std::find(rules.begin(), rules.end(), rule) == rules.end()) {
+            rules.push_back(rule);
+        }
+    }
+    return rules;
+}
+
+std::string compactRule(std::string rule) {
+    rule.erase(std::remove(rule.begin(), rule.end(), '/'), rule.end());
+    return rule;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int maxSize = 16384;
+
+    // Собственные параметры убираем до разбора параметров Google Benchmark
+    int kept = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--max-size=", 11) == 0) {
+            maxSize = std::atoi(argv[i] + 11);
+        } else {
+            argv[kept++] = argv[i];
+        }
+    }
+    argc = kept;
+
+    const int hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<int> threadCounts = {1};
+    if (hardwareThreads > 1) {
+        threadCounts.push_back(hardwareThreads);
+    }
+
+    std::vector<int> sizes;
+    for (int size = 64; size <= maxSize; size *= 4) {
+        sizes.push_back(size);
+    }
+
+    for (int size : sizes) {
+        for (const std::string& rule : loadRules()) {
+            for (int threads : threadCounts) {
+                for (bool tiles : {false, true}) {
+                    std::string name = "soup/size:" + std::to_string(size) + "/rule:" + compactRule(rule) +
+                                       "/threads:" + std::to_string(threads) + "/tiles:" + std::to_string(tiles);
+                    benchmark::RegisterBenchmark(name.c_str(), benchSoup, size, rule, threads, tiles)
+                        ->Unit(benchmark::kMicrosecond)
+                        ->UseRealTime();
+                }
+            }
+        }
+        for (const std::string& templateName : listFiles("templates")) {
+            for (int threads : threadCounts) {
+                for (bool tiles : {false, true}) {
+                    std::string name = "template/size:" + std::to_string(size) + "/pattern:" +
+                                       fs::path(templateName).stem().string() + "/threads:" +
+                                       std::to_string(threads) + "/tiles:" + std::to_string(tiles);
+                    benchmark::RegisterBenchmark(name.c_str(), benchTemplate, size, templateName, threads, tiles)
+                        ->Unit(benchmark::kMicrosecond)
+                        ->UseRealTime();
+                }
+            }
+        }
+    }
+
+    // Блокировка выигрывает только на полях, которые не помещаются в кэш
+    for (int size : sizes) {
+        if (size < 4096) {
+            continue;
+        }
+        for (int steps : {1, 2, 4, 8}) {
+            for (int threads : threadCounts) {
+                std::string name = "blocked/size:" + std::to_string(size) + "/steps:" + std::to_string(steps) +
+                                   "/threads:" + std::to_string(threads);
+                benchmark::RegisterBenchmark(name.c_str(), benchBlocked, size, steps, threads)
+                    ->Unit(benchmark::kMicrosecond)
+                    ->UseRealTime();
+            }
+        }
+    }
+
+    // Правила Larger than Life: время на клетку не должно расти с радиусом.
+    // Их ядро всегда считает поле целиком, поэтому плитки в имени не указываются
+    for (int size : sizes) {
+        if (size != 1024) {
+            continue;
+        }
+        for (bool moore : {true, false}) {
+            for (int range : {1, 5, 10}) {
+                for (int threads : threadCounts) {
+                    std::string name = "range/size:" + std::to_string(size) + "/neighborhood:" +
+                                       (moore ? "moore" : "vonneumann") + "/radius:" + std::to_string(range) +
+                                       "/threads:" + std::to_string(threads);
+                    benchmark::RegisterBenchmark(name.c_str(), benchSoup, size, rangeRule(range, moore), threads,
+                                                 false)
+                        ->Unit(benchmark::kMicrosecond)
+                        ->UseRealTime();
+                }
+            }
+        }
+    }
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,60 @@
+#ifndef ACTIVITYTRACKER_H
+#define ACTIVITYTRACKER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Отслеживание активности по плиткам 64x64 клетки (64 строки на одно слово строки).
+// Плитка, которая сама и все восемь соседей не изменились на прошлом шаге,
+// не изменится и на следующем, поэтому ее можно не пересчитывать.
+class ActivityTracker {
+public:
+    static constexpr int kTileRows = 64; // Высота плитки; ширина — одно 64-битное слово
+
+    ActivityTracker() = default;
+    ActivityTracker(int rows, int cols) { reset(rows, cols); }
+
+    // Задать размер поля; все плитки считаются изменившимися (следующий шаг будет полным)
+    void reset(int rows, int cols);
+
+    // Считать все плитки изменившимися без смены размера
+    void invalidate();
+
+    bool matches(int rows, int cols) const { return rows == numRows && cols == numCols; }
+    int tileRows() const { return numTileRows; }
+    int tileCols() const { return numTileCols; }
+    std::size_t tileCount() const { return changed.size(); }
+
+    // Подготовить шаг: собрать отрезки активных плиток по прошлым изменениям
+    void beginStep();
+
+    // Отрезки [first, second) подряд идущих активных плиток в ряду плиток tileRow
+    const std::pair<int, int>* runsBegin(int tileRow) const { return runs.data() + runOffsets[tileRow]; }
+    const std::pair<int, int>* runsEnd(int tileRow) const { return runs.data() + runOffsets[tileRow + 1]; }
+
+    // Отметить изменение плитки на текущем шаге (разные ряды плиток можно отмечать из разных потоков)
+    void markChanged(int tileRow, int tileCol) {
+        nextChanged[static_cast<std::size_t>(tileRow) * numTileCols + tileCol] = 1;
+    }
+
+    // Завершить шаг: изменения текущего шага становятся основой для следующего
+    void endStep() { changed.swap(nextChanged); }
+
+    // Сколько плиток было пересчитано на последнем шаге
+    std::size_t activeCount() const { return activeTiles; }
+
+private:
+    int numRows = 0;
+    int numCols = 0;
+    int numTileRows = 0;
+    int numTileCols = 0;
+    std::vector<std::uint8_t> changed;      // Плитка изменилась на прошлом шаге
+    std::vector<std::uint8_t> nextChanged;  // Плитка изменилась на текущем шаге
+    std::vector<std::pair<int, int>> runs;  // Отрезки активных плиток всех рядов подряд
+    std::vector<int> runOffsets;            // Начало отрезков каждого ряда в runs
+    std::size_t activeTiles = 0;
+};
+
+#endif // ACTIVITYTRACKER_H
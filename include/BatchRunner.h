@@ -0,0 +1,48 @@
+#ifndef BATCHRUNNER_H
+#define BATCHRUNNER_H
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Пакетный режим: задания из манифеста считаются без вывода на консоль и задержек в цикле шагов.
+// Независимые задания распределяются по потокам, на каждое выводится одна строка итогов.
+
+// Задание манифеста
+struct BatchJob {
+    std::string input;         // Входной файл любого формата: Life 1.06, RLE или снимок .snap
+    std::string rule;          // Правило вида B3/S23 или Larger than Life; заменяет правило из файла
+                               // ("-" — правило из файла, а если его там нет — B3/S23)
+    long long iterations = 0;  // Количество поколений
+    std::string output;        // Выходной файл ("-" — не сохранять)
+    int rows = 25;             // Размер поля (по умолчанию как в интерактивном режиме)
+    int cols = 50;
+    int line = 0;              // Номер строки в манифесте
+};
+
+// Итоги задания
+struct BatchResult {
+    bool ok = false;
+    std::string error;
+    std::size_t population = 0;
+    int rows = 0;              // Размер загруженного поля: у снимка .snap он берется из файла, а не из задания
+    int cols = 0;
+    double loadSeconds = 0;
+    double stepSeconds = 0;
+    double saveSeconds = 0;
+};
+
+// Прочитать манифест: по заданию в строке "input rule iterations output [rows cols]",
+// пустые строки и строки с '#' пропускаются. Об ошибочных строках сообщается в errors.
+// Возвращает false, если файл не открылся или в нем есть ошибки.
+bool readBatchManifest(const std::string& filename, std::vector<BatchJob>& jobs, std::ostream& errors);
+
+// Выполнить одно задание в текущем потоке
+BatchResult runBatchJob(const BatchJob& job);
+
+// Выполнить задания в threads потоков. Строки итогов пишутся в out по мере завершения заданий.
+// Возвращает количество неудачных заданий.
+int runBatch(const std::vector<BatchJob>& jobs, int threads, std::ostream& out);
+
+#endif // BATCHRUNNER_H
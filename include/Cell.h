@@ -1,10 +0,0 @@
-#ifndef CELL_H
-#define CELL_H
-
-// Класс для представления клетки
-class Cell {
-public:
-    bool isAlive = false; // Состояние клетки: жива или нет
-};
-
-#endif // CELL_H
@@ -0,0 +1,68 @@
+#ifndef CHECKPOINTER_H
+#define CHECKPOINTER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "Grid.h"
+#include "LifeKernel.h"
+
+// Периодические контрольные точки длинных прогонов.
+// submit копирует поле в буфер (память переиспользуется) и сразу возвращает управление,
+// а фоновый поток записывает снимок в файл "<prefix>.<поколение>.snap". Хранятся только
+// последние keep точек; более старые файлы удаляются после записи новой.
+class Checkpointer {
+public:
+    Checkpointer(std::string prefix, int keep);
+    ~Checkpointer();
+
+    Checkpointer(const Checkpointer&) = delete;
+    Checkpointer& operator=(const Checkpointer&) = delete;
+
+    // Передать поколение на запись. Если предыдущая точка еще ждет записи, она заменяется новой
+    void submit(const Grid& grid, const RuleMasks& rule, std::uint64_t generation);
+
+    // Дождаться записи всех переданных точек
+    void wait();
+
+    std::size_t writtenCount();
+    std::size_t droppedCount();
+
+    // Существующие точки с этим префиксом: пары (поколение, путь), по возрастанию поколения
+    static std::vector<std::pair<std::uint64_t, std::string>> list(const std::string& prefix);
+
+    // Путь к последней точке или пустая строка, если точек нет
+    static std::string latest(const std::string& prefix);
+
+private:
+    struct Slot {
+        Grid grid;
+        RuleMasks rule;
+        std::uint64_t generation = 0;
+    };
+
+    void writerLoop();
+
+    std::string prefix;
+    std::size_t keep;
+    std::vector<std::pair<std::uint64_t, std::string>> files; // Записанные точки по возрастанию поколения
+
+    std::mutex mutex;
+    std::condition_variable wakeWriter;
+    std::condition_variable idle;
+    Slot pending;                 // Точка, ожидающая записи
+    Slot writing;                 // Точка, которую сейчас записывает фоновый поток
+    bool hasPending = false;
+    bool busy = false;
+    bool stopping = false;
+    std::size_t written = 0;
+    std::size_t dropped = 0;
+    std::thread writer;
+};
+
+#endif // CHECKPOINTER_H
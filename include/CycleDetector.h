@@ -0,0 +1,59 @@
+#ifndef CYCLEDETECTOR_H
+#define CYCLEDETECTOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Grid.h"
+
+// Хеш поля в духе Zobrist: XOR вкладов отдельных слов, вклад зависит от слова и его номера.
+// Поэтому при шаге хеш обновляется только по изменившимся словам: hash ^= вклад(старое) ^ вклад(новое).
+// Пустые слова ничего не вносят, так что пустое поле любого размера имеет хеш 0.
+inline std::uint64_t gridWordHash(Grid::Word word, std::size_t index) {
+    if (word == 0) {
+        return 0;
+    }
+    std::uint64_t h = word ^ (index * 0x9E3779B97F4A7C15ull);
+    h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+    h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+    return h ^ (h >> 31);
+}
+
+// Хеш всего поля (полный пересчет)
+std::uint64_t gridHash(const Grid& grid);
+
+// Обнаружение повторяющихся состояний по хешам поколений.
+// История ограничена: запоминаются только последние historySize поколений, поэтому
+// находятся периоды не длиннее historySize. Таблица с открытой адресацией и ограниченной
+// длиной поиска: устаревшие записи просто перезаписываются, память после создания не выделяется.
+class CycleDetector {
+public:
+    explicit CycleDetector(std::size_t historySize = 4096);
+
+    // Запомнить хеш поколения generation. true — то же состояние уже было в пределах истории
+    bool record(std::uint64_t hash, long long generation);
+
+    // Период найденного цикла и поколение, в котором это состояние встречалось в прошлый раз
+    long long period() const { return foundPeriod; }
+    long long cycleStart() const { return foundStart; }
+
+    // Забыть историю (например, после изменения поля или правила)
+    void clear();
+
+private:
+    struct Entry {
+        std::uint64_t hash;
+        long long generation;
+    };
+
+    static constexpr std::size_t kProbeLimit = 16;
+    static constexpr long long kEmpty = -(1ll << 62);
+
+    std::vector<Entry> table;
+    std::size_t mask = 0;
+    long long history = 0;
+    long long foundPeriod = 0;
+    long long foundStart = 0;
+};
+
+#endif // CYCLEDETECTOR_H
@@ -0,0 +1,29 @@
+#ifndef DISTRIBUTED_H
+#define DISTRIBUTED_H
+
+#include <string>
+#include "Grid.h"
+#include "LifeKernel.h"
+
+// Расчет поля несколькими процессами на одной машине.
+// Поле делится на полосы строк, каждую полосу считает свой процесс (fork). Процессы соединены
+// в кольцо сокетами Unix: на каждом поколении соседи обмениваются граничными строками (гало
+// в одну клетку), а пока строки передаются, процесс считает внутренние строки своей полосы.
+// Кольцо замыкает поле по вертикали, а каждая полоса целиком по ширине замыкается сама,
+// поэтому результат совпадает с расчетом на торе в одном процессе бит в бит.
+// Каждый процесс держит в памяти только свою полосу с двумя строками гало.
+//
+// Вызывать, когда другие потоки программы не выделяют память (после fork в дочернем процессе
+// работает только вызвавший поток). workers не больше числа строк поля. Возвращают false
+// при ошибке (сообщение выводится в std::cerr).
+
+// Поле в памяти: процессы читают свою полосу из унаследованного поля, а итог родитель принимает
+// из каналов прямо в строки поля. При ошибке часть полос поля может оказаться уже рассчитанной
+bool runDistributed(Grid& grid, const RuleMasks& rule, long long generations, int workers);
+
+// Снимок в файле: поле не загружается ни в один процесс целиком — каждый процесс читает свою полосу
+// из снимка input и пишет итоговую полосу прямо в снимок output (правило и поколение берутся из input,
+// поколение в output больше на generations). При ошибке output удаляется
+bool runDistributed(const std::string& input, const std::string& output, long long generations, int workers);
+
+#endif // DISTRIBUTED_H
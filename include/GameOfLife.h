@@ -9,40 +9,106 @@
 #include <algorithm>
 #include <thread>
 #include <filesystem>
-#include "Cell.h" // Подключаем заголовок Cell.h
+#include <memory>
+#include "Grid.h" // Битовое поле клеток
+#include "LifeKernel.h"
+#include "RangeRule.h"
+#include "ThreadPool.h"
+#include "ActivityTracker.h"
+#include "CycleDetector.h"
+#include "Metrics.h"
 
 // Функция для проверки, заканчивается ли строка на заданный суффикс
 bool endsWith(const std::string& str, const std::string& suffix);
 
+// Изменение сводки поля за шаг (вклад в хеш, рождения и смерти)
+struct StepDelta {
+    std::uint64_t hash = 0;
+    std::uint64_t births = 0;
+    std::uint64_t deaths = 0;
+};
+
 // Класс игры "Жизнь"
 class Game {
 public:
     std::string gameName;
-    std::vector<std::vector<Cell>> field;
+    Grid field;
+    Grid nextField; // Второй буфер поколения: сюда пишется следующее состояние, затем буферы меняются местами
     std::vector<int> birthRules = {3};
     std::vector<int> survivalRules = {2, 3};
+    RuleMasks ruleMasks = ruleMasksFromString("B3/S23"); // Правила, скомпилированные parseRules в маски
+    // Правило Larger than Life (R5,C0,M1,S34..58,B34..45,NM). Если оно задано, шаг считает RangeKernel,
+    // а birthRules и survivalRules перечисляют все числа соседей из диапазонов B и S
+    RangeRule rangeRule;
+    RangeKernel rangeKernel;
     int numRows = 0;
     int numCols = 0;
-    int curIteration = 1;
+    long long curIteration = 1; // Номер текущего поколения (растет с каждым шагом)
+    const KernelInfo* kernel = &activeKernel(); // Набор ядер расчета (по умолчанию самый быстрый)
+    std::shared_ptr<ThreadPool> threadPool;    // Пул потоков для расчета полос строк (нет — один поток)
+
+    // Пересчет только активных плиток 64x64: тех, что менялись на прошлом шаге, и их соседей
+    bool trackActivity = true;
+    ActivityTracker activity;
+    std::size_t activeTiles = 0;               // Сколько плиток пересчитано на последнем шаге
+    std::uint64_t trackedVersion = 0;          // Версия field после последнего шага
+    RuleMasks trackedRule;                     // Правило, по которому считался последний шаг
+
+    // Сводка поля, обновляемая на шаге только по изменившимся словам: хеш (см. CycleDetector.h),
+    // число живых клеток, рождения и смерти. Нужна для поиска циклов и метрик поколений
+    bool trackHash = false;                           // Поддерживать сводку для stateHash
+    bool collectStats = false;                        // Поддерживать сводку и записывать ее в метрики
+    std::uint64_t fieldHash = 0;
+    std::uint64_t population = 0;
+    std::uint64_t births = 0;                         // Рождения и смерти на последнем шаге
+    std::uint64_t deaths = 0;
+    std::uint64_t summaryVersion = ~std::uint64_t(0); // Версия field, для которой посчитана сводка
+    std::vector<StepDelta> stepDeltas;                // Изменение сводки по рядам плиток на последнем шаге
+
+    bool verbose = true; // Сообщать на консоль о загрузке и сохранении файлов (ошибки выводятся всегда)
+
+    // Временная блокировка в advance: поле проходится полосами размером с кэш, и каждая полоса
+    // продвигается сразу на blockSteps поколений, так что поле читается из памяти один раз за blockSteps шагов
+    static constexpr std::size_t kBlockCacheBytes = std::size_t(512) << 10; // Буферы полосы одного потока
+    int blockSteps = 1;
+    std::vector<Grid::Word> blockScratch; // Промежуточные поколения полос (по два буфера на поток)
 
     // Конструктор
     Game(std::string name, int rows, int cols)
-        : gameName(std::move(name)), numRows(rows), numCols(cols) {
-        field.resize(numRows, std::vector<Cell>(numCols));
-    }
+        : gameName(std::move(name)), field(rows, cols), nextField(rows, cols), numRows(rows), numCols(cols),
+          activity(rows, cols) {}
 
     // Методы
-    void readFromFile(const std::string& filename);
+    void setThreads(int threads);
+    void resize(int rows, int cols); // Изменить размер поля (все клетки становятся мертвыми)
+    // Формат файла выбирается по расширению: .rle — RLE, .snap — двоичный снимок
+    // (восстанавливает размер, правило и номер поколения), иначе Life 1.06. false — файл не прочитан
+    bool readFromFile(const std::string& filename);
     void generateRandomState();
     void printState();
-    void saveToFile(const std::string& filename);
+    bool saveToFile(const std::string& filename);
+    // Сохранить поле grid поколения iteration с именем и правилом игры (например, снимок из потока расчета)
+    bool saveToFile(const std::string& filename, const Grid& grid, long long iteration);
     void calculateNextState();
+    void calculateNextStateReference();
+    // Рассчитать generations поколений: по одному (blockSteps <= 1) или блоками по blockSteps.
+    // Промежуточные поколения блока не видны: сводка поля и метрики поколений по ним не ведутся
+    void advance(long long generations);
+    void calculateNextStates(int steps); // Один проход по полю на steps поколений
+    // Сразу после calculateNextState во втором буфере лежит прошлое поколение (curIteration - 1):
+    // обменять этот буфер с grid без копирования поля. Следующий шаг пересчитывает все плитки,
+    // потому что пропуск неактивных плиток опирается на прошлое поколение во втором буфере
+    void exchangePreviousGeneration(Grid& grid);
+    std::uint64_t stateHash(); // Хеш текущего поколения (пересчитывается целиком, только если поле меняли снаружи)
+    void refreshSummary();     // Пересчитать сводку поля целиком, если поле меняли снаружи
     int countNeighbors(int row, int col);
+    // Правило вида B3/S23 или Larger than Life (R5,C0,M1,S34..58,B34..45,NM)
     void parseRules(const std::string& ruleString);
+    std::string ruleString() const; // Текущее правило в том же виде
     void parseSize(const std::string& sizeString);
     void parseCell(const std::string& cellString);
     
-    // Загрузить шаблон с координатами
+    // Загрузить шаблон с координатами: шаблон из кэша (см. PatternCache) накладывается по OR, края замыкаются
     void loadTemplate(const std::string& filename, int startX, int startY);
 
     // Загрузить правила из файла
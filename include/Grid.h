@@ -0,0 +1,94 @@
+#ifndef GRID_H
+#define GRID_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Битовое поле клеток: один бит на клетку, 64 клетки в слове.
+// Каждая строка начинается с нового слова, все строки лежат в одном непрерывном буфере.
+// Неиспользуемые старшие биты последнего слова строки всегда равны нулю.
+class Grid {
+public:
+    using Word = std::uint64_t;
+    static constexpr int kWordBits = 64;
+
+    Grid() = default;
+    Grid(int rows, int cols) { resize(rows, cols); }
+
+    // Изменить размер поля (все клетки становятся мертвыми)
+    void resize(int rows, int cols);
+
+    // Сделать все клетки мертвыми
+    void clear();
+
+    int rows() const { return numRows; }
+    int cols() const { return numCols; }
+    int wordsPerRow() const { return rowWords; }
+    std::size_t wordCount() const { return words.size(); }
+
+    bool get(int row, int col) const {
+        return (words[wordIndex(row, col)] >> (col % kWordBits)) & 1u;
+    }
+
+    void set(int row, int col, bool alive) {
+        ++modifications;
+        Word bit = Word(1) << (col % kWordBits);
+        Word& word = words[wordIndex(row, col)];
+        word = alive ? (word | bit) : (word & ~bit);
+    }
+
+    // Неконстантный доступ к словам считается изменением поля (см. version)
+    Word* rowData(int row) {
+        ++modifications;
+        return words.data() + static_cast<std::size_t>(row) * rowWords;
+    }
+    const Word* rowData(int row) const { return words.data() + static_cast<std::size_t>(row) * rowWords; }
+    Word* data() {
+        ++modifications;
+        return words.data();
+    }
+    const Word* data() const { return words.data(); }
+
+    // Счетчик изменений: растет при каждой записи, по нему можно понять, что поле меняли
+    std::uint64_t version() const { return modifications; }
+
+    // Маска значащих битов последнего слова строки
+    Word tailMask() const;
+
+    // Количество живых клеток
+    std::size_t population() const;
+
+    // Объем памяти, занимаемый клетками, в байтах
+    std::size_t memoryBytes() const { return words.size() * sizeof(Word); }
+
+    // Обменять содержимое двух полей без копирования и выделения памяти
+    void swap(Grid& other) noexcept {
+        words.swap(other.words);
+        std::swap(numRows, other.numRows);
+        std::swap(numCols, other.numCols);
+        std::swap(rowWords, other.rowWords);
+        std::swap(modifications, other.modifications);
+    }
+
+    bool operator==(const Grid& other) const;
+    bool operator!=(const Grid& other) const { return !(*this == other); }
+
+private:
+    std::size_t wordIndex(int row, int col) const {
+        return static_cast<std::size_t>(row) * rowWords + col / kWordBits;
+    }
+
+    std::vector<Word> words;
+    int numRows = 0;
+    int numCols = 0;
+    int rowWords = 0;
+    std::uint64_t modifications = 0;
+};
+
+inline void swap(Grid& a, Grid& b) noexcept {
+    a.swap(b);
+}
+
+#endif // GRID_H
@@ -0,0 +1,119 @@
+#ifndef HASHLIFE_H
+#define HASHLIFE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Grid.h"
+#include "LifeKernel.h"
+
+// Движок Hashlife (алгоритм Госпера) для очень длинных прогонов на бесконечной плоскости.
+// Поле хранится как канонизированное квадродерево: одинаковые квадраты — это один и тот же узел,
+// а результат узла (его центр через 2^k поколений) запоминается. Поэтому повторяющиеся
+// структуры считаются один раз, а 2^k поколений продвигаются одним вызовом.
+// Размер кэша узлов ограничен; при приближении к пределу выполняется сборка мусора — между шагами
+// и внутри шага, а шаг, которому не хватает памяти и после нее, дробится на шаги вдвое короче.
+class HashLife {
+public:
+    using NodeId = std::uint32_t;
+
+    // memoryBudget — ограничение памяти под узлы и хеш-таблицу в байтах
+    explicit HashLife(const RuleMasks& rule, std::size_t memoryBudget = std::size_t(256) << 20);
+
+    // Сделать клетку живой или мертвой; координаты могут быть отрицательными
+    void setCell(std::int64_t x, std::int64_t y, bool alive);
+    bool getCell(std::int64_t x, std::int64_t y) const;
+
+    // Скопировать живые клетки из поля (x — столбец, y — строка) и обратно в окно [0, rows) x [0, cols)
+    void loadFromGrid(const Grid& grid);
+    void copyToGrid(Grid& grid) const;
+
+    // Чтение файла любого формата (Life 1.06, RLE, снимок; см. readCells) и запись в формате Life 1.06
+    // (как Game::readFromFile/saveToFile)
+    void readFromFile(const std::string& filename);
+    void saveToFile(const std::string& filename, const std::string& name) const;
+
+    // Продвинуть поле на generations поколений (степенями двойки, от большей к меньшей)
+    void advance(std::uint64_t generations);
+
+    // Продвинуть поле ровно на 2^log2Generations поколений одним рекурсивным вызовом
+    void advancePowerOfTwo(int log2Generations);
+
+    std::uint64_t population() const { return nodes[root].population; }
+    std::uint64_t generation() const { return generationCount; }
+    std::size_t nodeCount() const { return nodes.size(); }
+    std::size_t maxNodes() const { return nodeLimit; }
+    std::size_t garbageCollections() const { return gcCount; }
+    std::size_t peakNodeCount() const { return std::max(peakNodes, nodes.size()); } // Наибольшее число узлов
+
+    // Удалить узлы, недостижимые из текущего поля и из кадров незаконченного шага
+    // (запомненные результаты живых узлов сохраняются)
+    void collectGarbage();
+
+    // Обойти все живые клетки
+    template <typename Visitor>
+    void forEachCell(Visitor&& visit) const {
+        std::int64_t half = nodes[root].level == 0 ? 0 : std::int64_t(1) << (nodes[root].level - 1);
+        visitCells(root, -half, -half, visit);
+    }
+
+private:
+    static constexpr NodeId kNoNode = ~NodeId(0);
+    static constexpr NodeId kDeadCell = 0;
+    static constexpr NodeId kLiveCell = 1;
+    static constexpr int kMaxLevel = 62;
+
+    struct Node {
+        std::uint64_t population;    // Число живых клеток (с насыщением)
+        NodeId nw, ne, sw, se;       // Четверти (у клеток нулевого уровня не используются)
+        NodeId result;               // Запомненный центр через 2^resultStep поколений
+        std::uint8_t level;          // Сторона квадрата — 2^level клеток
+        std::uint8_t resultStep;
+    };
+
+    NodeId join(NodeId nw, NodeId ne, NodeId sw, NodeId se);
+    NodeId emptyNode(int level);
+    NodeId expand(NodeId node);
+    NodeId centerNode(NodeId node);
+    NodeId horizontalCenter(NodeId west, NodeId east);
+    NodeId verticalCenter(NodeId north, NodeId south);
+    NodeId successor(NodeId node, int step);
+    NodeId baseSuccessor(NodeId node);
+    NodeId setCellIn(NodeId node, std::int64_t x, std::int64_t y, bool alive);
+    bool isCentered(NodeId node) const;
+    void growToContain(std::int64_t x, std::int64_t y);
+    void rehash(std::size_t slotCount);
+    NodeId copyReachable(NodeId node, std::vector<Node>& target, std::vector<NodeId>& remap) const;
+
+    template <typename Visitor>
+    void visitCells(NodeId node, std::int64_t x, std::int64_t y, Visitor& visit) const {
+        const Node& n = nodes[node];
+        if (n.population == 0) {
+            return;
+        }
+        if (n.level == 0) {
+            visit(x, y);
+            return;
+        }
+        std::int64_t half = std::int64_t(1) << (n.level - 1);
+        visitCells(n.nw, x, y, visit);
+        visitCells(n.ne, x + half, y, visit);
+        visitCells(n.sw, x, y + half, visit);
+        visitCells(n.se, x + half, y + half, visit);
+    }
+
+    RuleMasks rule;
+    std::vector<Node> nodes;
+    std::vector<NodeId> table;       // Открытая адресация: индексы узлов, kNoNode — пусто
+    std::vector<NodeId> emptyNodes;  // Пустой узел каждого уровня
+    std::vector<NodeId> pinned;      // Узлы незаконченных вызовов successor (корни для сборки мусора)
+    NodeId root = kDeadCell;
+    std::uint64_t generationCount = 0;
+    std::size_t nodeLimit = 0;
+    std::size_t gcCount = 0;
+    std::size_t peakNodes = 0;
+};
+
+#endif // HASHLIFE_H
@@ -0,0 +1,56 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Grid.h"
+
+// Сжатая история поколений. Каждое K-е поколение хранится ключевым кадром, остальные — разностью
+// (XOR) с предыдущим записанным поколением. За шаг меняется мало клеток, поэтому в разность
+// попадают только изменившиеся слова: пропуск нулевых слов (varint), маска ненулевых байтов
+// слова и сами эти байты. Ключевой кадр кодируется так же — как разность с пустым полем.
+// Переход к любому поколению восстанавливает ключевой кадр и применяет не больше K - 1 разностей.
+class History {
+public:
+    explicit History(int keyframeInterval = 64);
+
+    // Записать поколение. Следующее по номеру поколение записывается разностью; пропуск поколений
+    // начинает новый ключевой кадр, а поколение не больше уже записанного или другой размер поля
+    // начинают историю заново
+    void record(const Grid& grid, long long generation);
+
+    // Восстановить поколение generation в grid (размер поля меняется на размер истории).
+    // false — такое поколение не записано
+    bool seek(long long generation, Grid& grid) const;
+
+    void clear();
+
+    bool empty() const { return keyframes.empty(); }
+    long long firstGeneration() const { return keyframes.empty() ? 0 : keyframes.front().generation; }
+    long long lastGeneration() const { return last; }
+    std::size_t generationCount() const { return recorded; }
+    std::size_t keyframeCount() const { return keyframes.size(); }
+
+    // Память под историю и сколько заняли бы те же поколения целыми полями
+    std::size_t memoryBytes() const;
+    std::size_t uncompressedBytes() const { return recorded * previous.memoryBytes(); }
+
+private:
+    struct Keyframe {
+        long long generation; // Поколение ключевого кадра, следующие записи — generation + 1, ...
+        std::size_t offset;   // Начало кадра в data
+        std::size_t count;    // Сколько поколений записано начиная с кадра (включая сам кадр)
+    };
+
+    void appendDelta(const Grid::Word* before, const Grid::Word* after, std::size_t words);
+
+    int interval;
+    std::vector<std::uint8_t> data;
+    std::vector<Keyframe> keyframes;
+    Grid previous; // Последнее записанное поколение: от него считается следующая разность
+    long long last = 0;
+    std::size_t recorded = 0;
+};
+
+#endif // HISTORY_H
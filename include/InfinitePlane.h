@@ -0,0 +1,92 @@
+#ifndef INFINITEPLANE_H
+#define INFINITEPLANE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Grid.h"
+#include "LifeKernel.h"
+
+// Бесконечная плоскость без замыкания краев.
+// Клетки хранятся плитками 64x64 (64 слова по строке плитки), плитки создаются по мере роста
+// узора и удаляются, когда становятся пустыми, поэтому память пропорциональна занятой площади.
+// Координаты 64-битные и могут быть отрицательными.
+class InfinitePlane {
+public:
+    static constexpr int kTileSize = 64;
+
+    struct TileKey {
+        std::int64_t x;
+        std::int64_t y;
+
+        bool operator==(const TileKey& other) const { return x == other.x && y == other.y; }
+        bool operator<(const TileKey& other) const { return y != other.y ? y < other.y : x < other.x; }
+    };
+
+    using Tile = std::array<Grid::Word, kTileSize>;
+
+    explicit InfinitePlane(const RuleMasks& rule);
+
+    void setCell(std::int64_t x, std::int64_t y, bool alive);
+    bool getCell(std::int64_t x, std::int64_t y) const;
+
+    // Скопировать живые клетки из поля (x — столбец, y — строка) и обратно в окно [0, rows) x [0, cols)
+    void loadFromGrid(const Grid& grid);
+    void copyToGrid(Grid& grid) const;
+
+    // Чтение файла любого формата (Life 1.06, RLE, снимок; см. readCells) и запись в формате Life 1.06
+    // (как Game::readFromFile/saveToFile, но без обрезки)
+    void readFromFile(const std::string& filename);
+    void saveToFile(const std::string& filename, const std::string& name) const;
+
+    // Рассчитать следующее поколение
+    void step();
+    void advance(std::uint64_t generations);
+
+    std::uint64_t population() const;
+    std::uint64_t generation() const { return generationCount; }
+    std::size_t tileCount() const { return tiles.size(); }
+
+    // Примерный объем памяти под плитки в байтах
+    std::size_t memoryBytes() const;
+
+    // Обойти все живые клетки (плитки в порядке строк, внутри плитки — по строкам)
+    template <typename Visitor>
+    void forEachCell(Visitor&& visit) const {
+        for (const TileKey& key : sortedKeys()) {
+            const Tile& tile = tiles.at(key);
+            for (int row = 0; row < kTileSize; ++row) {
+                for (Grid::Word word = tile[row]; word != 0; word &= word - 1) {
+                    int col = __builtin_ctzll(word);
+                    visit(key.x * kTileSize + col, key.y * kTileSize + row);
+                }
+            }
+        }
+    }
+
+private:
+    struct TileKeyHash {
+        std::size_t operator()(const TileKey& key) const {
+            std::uint64_t h = static_cast<std::uint64_t>(key.x) * 0x9E3779B97F4A7C15ull;
+            h ^= static_cast<std::uint64_t>(key.y) + 0x632BE59BD9B4E019ull + (h << 6) + (h >> 2);
+            return static_cast<std::size_t>(h ^ (h >> 31));
+        }
+    };
+
+    using TileMap = std::unordered_map<TileKey, Tile, TileKeyHash>;
+
+    const Tile* findTile(std::int64_t x, std::int64_t y) const;
+    bool computeTile(const TileKey& key, Tile& out) const;
+    std::vector<TileKey> sortedKeys() const;
+
+    RuleMasks rule;
+    TileMap tiles;
+    TileMap nextTiles;
+    std::vector<TileKey> candidates;  // Плитки, которые нужно пересчитать на шаге
+    std::uint64_t generationCount = 0;
+};
+
+#endif // INFINITEPLANE_H
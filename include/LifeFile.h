@@ -0,0 +1,149 @@
+#ifndef LIFEFILE_H
+#define LIFEFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+#include "Grid.h"
+#include "LifeKernel.h"
+
+// Общие функции для файлов поля: Life 1.06 (строка "x y" на каждую живую клетку),
+// RLE (стандартный формат обмена узорами) и двоичный снимок упакованного поля
+
+// Строка правила вида "B3/S23"
+std::string formatRule(const RuleMasks& rule);
+
+// Разобрать правило вида "B3/S23" (или "b3/s23"); false — строка не является правилом
+bool parseRuleMasks(const std::string& text, RuleMasks& rule);
+
+// Файл, отображенный в память только для чтения. Пустой файл дает пустой диапазон
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& filename);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool isOpen() const { return opened; }
+    const char* begin() const { return data; }
+    const char* end() const { return data + length; }
+    std::size_t size() const { return length; }
+
+private:
+    const char* data = nullptr;
+    std::size_t length = 0;
+    bool opened = false;
+};
+
+// Буферизованная запись: текст собирается в буфере и пишется в файл крупными блоками
+class FileWriter {
+public:
+    explicit FileWriter(const std::string& filename);
+    ~FileWriter() { close(); }
+
+    FileWriter(const FileWriter&) = delete;
+    FileWriter& operator=(const FileWriter&) = delete;
+
+    bool isOpen() const { return file != nullptr; }
+
+    void write(const char* text, std::size_t size);
+    void write(const std::string& text) { write(text.data(), text.size()); }
+    void write(const char* text) { write(text, std::strlen(text)); }
+    void put(char c) {
+        if (used == buffer.size()) {
+            flush();
+        }
+        buffer[used++] = c;
+    }
+    void writeInt(std::int64_t value);
+
+    // Записать буфер и закрыть файл; false — при записи произошла ошибка
+    bool close();
+
+private:
+    void flush();
+
+    std::FILE* file = nullptr;
+    std::vector<char> buffer;
+    std::size_t used = 0;
+    bool failed = false;
+};
+
+// Прочитать живые клетки из файла Life 1.06; cell(x, y) вызывается для каждой клетки.
+// Координаты 64-битные и могут быть отрицательными. Возвращает false, если файл не открылся.
+bool readLife106(const std::string& filename, const std::function<void(std::int64_t x, std::int64_t y)>& cell);
+
+// Записать заголовок файла Life 1.06: формат, имя и правило
+void writeLife106Header(FileWriter& out, const std::string& name, const RuleMasks& rule);
+
+// Записать живые клетки поля строками "x y" (x — столбец, y — строка)
+void writeLife106Cells(FileWriter& out, const Grid& grid);
+
+// Прочитать файл RLE; cell(x, y) вызывается для каждой живой клетки, координаты отсчитываются
+// от левого верхнего угла узора. Правило из заголовка (если есть) записывается в rule.
+// Возвращает false, если файл не открылся.
+bool readRle(const std::string& filename, const std::function<void(std::int64_t x, std::int64_t y)>& cell,
+             std::string& rule);
+
+// Записать поле целиком в формате RLE (размер узора равен размеру поля, чтобы положение клеток сохранялось)
+bool writeRle(const std::string& filename, const Grid& grid, const std::string& name, const RuleMasks& rule);
+// То же с правилом, уже записанным строкой (например, Larger than Life)
+bool writeRle(const std::string& filename, const Grid& grid, const std::string& name, const std::string& rule);
+
+// Заголовок двоичного снимка. Слова поля хранятся в порядке байтов машины,
+// поэтому в заголовок записывается метка порядка байтов. За заголовком сразу идут слова поля,
+// после них — контрольная сумма, если в flags есть kHasChecksum
+struct SnapshotHeader {
+    char magic[8];
+    std::uint32_t byteOrder;
+    std::uint32_t rows;
+    std::uint32_t cols;
+    std::uint16_t birth;
+    std::uint16_t survival;
+    std::uint32_t flags;
+    std::uint32_t reserved;
+    std::uint64_t generation;
+};
+static_assert(sizeof(SnapshotHeader) == 40, "Snapshot header must not contain padding");
+
+constexpr char kSnapshotMagic[8] = {'G', 'O', 'L', 'S', 'N', 'A', 'P', '1'};
+constexpr std::uint32_t kByteOrderMark = 0x01020304;
+constexpr std::uint32_t kHasChecksum = 1;
+
+// Двоичный снимок: заголовок (размер, правило, поколение) и слова упакованного поля как есть.
+// Контрольная сумма слов проверяется при чтении, если она была записана.
+bool writeSnapshot(const std::string& filename, const Grid& grid, const RuleMasks& rule, std::uint64_t generation,
+                   bool withChecksum = true);
+
+// Прочитать и проверить заголовок снимка, не читая слов: метку, порядок байтов, размер поля
+// и длину файла (слова и контрольная сумма должны в нем поместиться). Ошибки выводятся в std::cerr.
+bool readSnapshotHeader(const std::string& filename, SnapshotHeader& header);
+
+// Число слов поля в снимке с таким заголовком
+std::size_t snapshotWordCount(const SnapshotHeader& header);
+
+// Прочитать снимок: размер поля меняется на размер из снимка. Ошибки выводятся в std::cerr.
+bool readSnapshot(const std::string& filename, Grid& grid, RuleMasks& rule, std::uint64_t& generation);
+
+// Прочитать живые клетки из файла любого формата (выбирается по расширению: .rle, .snap, иначе Life 1.06).
+// Правило и размер из файла не используются (правило читает readFileRule). Возвращает false, если файл не прочитан.
+bool readCells(const std::string& filename, const std::function<void(std::int64_t x, std::int64_t y)>& cell);
+
+// Правило из заголовка файла без чтения клеток: rule = ... из RLE, маски из снимка.
+// Пустая строка — в файле нет правила (Life 1.06 или RLE без параметра rule). false — файл не открылся
+bool readFileRule(const std::string& filename, std::string& rule);
+
+// Контрольная сумма слов поля
+std::uint64_t gridChecksum(const Grid::Word* words, std::size_t count);
+
+// Та же сумма по частям, когда поле целиком не лежит в памяти: начать с gridChecksumStart(общее число слов)
+// и передать все слова по порядку в gridChecksumUpdate
+std::uint64_t gridChecksumStart(std::size_t count);
+std::uint64_t gridChecksumUpdate(std::uint64_t hash, const Grid::Word* words, std::size_t count);
+
+#endif // LIFEFILE_H
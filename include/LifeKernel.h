@@ -0,0 +1,223 @@
+#ifndef LIFEKERNEL_H
+#define LIFEKERNEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include "Grid.h"
+
+// Битово-параллельное (SWAR) вычисление следующего поколения.
+// Каждый бит слова — отдельная клетка, поэтому за одну операцию обрабатывается 64 клетки.
+// Число соседей считается сумматорами по битовым плоскостям: count = b0 + 2*b1 + 4*b2 + 8*b3.
+
+// Полусумматор: sum = a ^ b, carry = a & b
+template <typename V>
+inline void halfAdd(V a, V b, V& sum, V& carry) {
+    sum = a ^ b;
+    carry = a & b;
+}
+
+// Полный сумматор трех битовых векторов
+template <typename V>
+inline void fullAdd(V a, V b, V c, V& sum, V& carry) {
+    V t = a ^ b;
+    sum = t ^ c;
+    carry = (a & b) | (t & c);
+}
+
+// Маска клеток, у которых ровно count соседей
+template <typename V>
+inline V countEquals(int count, V b0, V b1, V b2, V b3) {
+    V r = (count & 1) ? b0 : ~b0;
+    r = r & ((count & 2) ? b1 : ~b1);
+    r = r & ((count & 4) ? b2 : ~b2);
+    return r & ((count & 8) ? b3 : ~b3);
+}
+
+// Маски правил B/S: бит k установлен, если k соседей приводят к рождению/выживанию.
+// По сути это таблица 2x9: для мертвой и живой клетки и каждого числа соседей.
+struct RuleMasks {
+    std::uint16_t birth = 0;
+    std::uint16_t survival = 0;
+
+    constexpr bool operator==(const RuleMasks& other) const {
+        return birth == other.birth && survival == other.survival;
+    }
+    constexpr bool operator!=(const RuleMasks& other) const { return !(*this == other); }
+};
+
+// Разбор строки вида "B3/S23" на этапе компиляции (те же правила, что и в Game::parseRules)
+constexpr RuleMasks ruleMasksFromString(const char* text) {
+    RuleMasks rule;
+    bool survival = false;
+    for (const char* c = text; *c != '\0'; ++c) {
+        if (*c == '/') {
+            survival = true;
+        } else if (*c >= '0' && *c <= '8') {
+            std::uint16_t bit = static_cast<std::uint16_t>(1u << (*c - '0'));
+            if (survival) {
+                rule.survival |= bit;
+            } else {
+                rule.birth |= bit;
+            }
+        }
+    }
+    return rule;
+}
+
+// Правила, для которых ядра специализируются на этапе компиляции:
+// классические и все правила из каталога rules/
+inline constexpr RuleMasks kFixedRules[] = {
+    ruleMasksFromString("B3/S23"),  // Conway
+    ruleMasksFromString("B36/S23"), // HighLife
+    ruleMasksFromString("B2/S23"),  // rules/dense_cluster.txt
+    ruleMasksFromString("B3/S12"),  // rules/explosion.txt
+    ruleMasksFromString("B4/S23"),  // rules/rapid_spread.txt
+};
+
+// Маска клеток, число соседей которых входит в набор countMask (бит k — k соседей)
+template <typename V>
+inline V countMatches(std::uint16_t countMask, V b0, V b1, V b2, V b3) {
+    V r = b0 & ~b0;
+    for (int count = 0; count <= 8; ++count) {
+        if (countMask & (1u << count)) {
+            r = r | countEquals(count, b0, b1, b2, b3);
+        }
+    }
+    return r;
+}
+
+// То же для набора, известного на этапе компиляции: лишние сравнения не генерируются
+template <std::uint16_t CountMask, int Count = 0, typename V>
+inline V countMatchesFixed(V b0, V b1, V b2, V b3) {
+    if constexpr (Count > 8) {
+        return b0 & ~b0;
+    } else {
+        V rest = countMatchesFixed<CountMask, Count + 1>(b0, b1, b2, b3);
+        if constexpr (((CountMask >> Count) & 1u) != 0) {
+            return rest | countEquals(Count, b0, b1, b2, b3);
+        } else {
+            return rest;
+        }
+    }
+}
+
+// Применение правила, заданного масками во время выполнения
+template <typename V>
+inline V applyRule(const RuleMasks& rule, V mid, V b0, V b1, V b2, V b3) {
+    V born = countMatches(rule.birth, b0, b1, b2, b3);
+    V survived = countMatches(rule.survival, b0, b1, b2, b3);
+    return (mid & survived) | (~mid & born);
+}
+
+// Правило как параметр шаблона: во внутреннем цикле нет обращений к маскам
+template <std::uint16_t Birth, std::uint16_t Survival>
+struct FixedRule {};
+
+template <std::uint16_t Birth, std::uint16_t Survival, typename V>
+inline V applyRule(FixedRule<Birth, Survival>, V mid, V b0, V b1, V b2, V b3) {
+    V born = countMatchesFixed<Birth>(b0, b1, b2, b3);
+    V survived = countMatchesFixed<Survival>(b0, b1, b2, b3);
+    return (mid & survived) | (~mid & born);
+}
+
+// Новое состояние 64 (или больше для векторных типов) клеток по восьми сдвинутым соседям
+template <typename V, typename Rule>
+inline V nextCells(V upW, V up, V upE, V midW, V mid, V midE, V downW, V down, V downE, const Rule& rule) {
+    V upSum, upCarry, downSum, downCarry, midSum, midCarry;
+    fullAdd(upW, up, upE, upSum, upCarry);
+    fullAdd(downW, down, downE, downSum, downCarry);
+    halfAdd(midW, midE, midSum, midCarry);
+
+    V b0, onesCarry;
+    fullAdd(upSum, downSum, midSum, b0, onesCarry);
+
+    V twos, twosCarry, b1, fours;
+    fullAdd(upCarry, downCarry, midCarry, twos, twosCarry);
+    halfAdd(twos, onesCarry, b1, fours);
+
+    V b2 = twosCarry ^ fours;
+    V b3 = twosCarry & fours;
+
+    return applyRule(rule, mid, b0, b1, b2, b3);
+}
+
+// Вычислить слова [wordBegin, wordEnd) строки out по строкам up, mid, down.
+// Строки имеют ширину cols клеток и замыкаются по горизонтали (тор).
+using RowKernel = void (*)(const Grid::Word* up, const Grid::Word* mid, const Grid::Word* down,
+                           Grid::Word* out, int cols, int wordBegin, int wordEnd, const RuleMasks& rule);
+
+// Переносимая реализация на 64-битных словах
+void stepRowScalar(const Grid::Word* up, const Grid::Word* mid, const Grid::Word* down,
+                   Grid::Word* out, int cols, int wordBegin, int wordEnd, const RuleMasks& rule);
+
+// Ядро, специализированное под правило из kFixedRules, или nullptr
+RowKernel findRowKernelScalar(const RuleMasks& rule);
+
+#ifdef GOL_HAVE_AVX2
+// 256 клеток за операцию; требует поддержки AVX2 процессором
+void stepRowAvx2(const Grid::Word* up, const Grid::Word* mid, const Grid::Word* down,
+                 Grid::Word* out, int cols, int wordBegin, int wordEnd, const RuleMasks& rule);
+RowKernel findRowKernelAvx2(const RuleMasks& rule);
+#endif
+
+#ifdef GOL_HAVE_AVX512
+// 512 клеток за операцию; требует поддержки AVX-512F процессором
+void stepRowAvx512(const Grid::Word* up, const Grid::Word* mid, const Grid::Word* down,
+                   Grid::Word* out, int cols, int wordBegin, int wordEnd, const RuleMasks& rule);
+RowKernel findRowKernelAvx512(const RuleMasks& rule);
+#endif
+
+// Описание реализации ядра
+struct KernelInfo {
+    const char* name;
+    RowKernel step;                                // Общее ядро: правило берется из масок
+    RowKernel (*findFixed)(const RuleMasks& rule); // Специализированное ядро или nullptr
+
+    // Ядро для правила: специализированное, если оно есть, иначе общее
+    RowKernel select(const RuleMasks& rule) const {
+        RowKernel fixed = findFixed(rule);
+        return fixed != nullptr ? fixed : step;
+    }
+};
+
+// Поиск специализации Kernel<birth, survival>::step для правила из kFixedRules
+template <template <std::uint16_t, std::uint16_t> class Kernel, std::size_t... Index>
+RowKernel findFixedKernel(const RuleMasks& rule, std::index_sequence<Index...>) {
+    RowKernel result = nullptr;
+    // Поля сравниваются напрямую: функция инстанцируется и в файлах с AVX-флагами,
+    // и общие inline-функции из них не должны попадать в скалярный код
+    ((result == nullptr && rule.birth == kFixedRules[Index].birth && rule.survival == kFixedRules[Index].survival
+          ? static_cast<void>(result = &Kernel<kFixedRules[Index].birth, kFixedRules[Index].survival>::step)
+          : static_cast<void>(0)),
+     ...);
+    return result;
+}
+
+template <template <std::uint16_t, std::uint16_t> class Kernel>
+RowKernel findFixedKernel(const RuleMasks& rule) {
+    return findFixedKernel<Kernel>(rule, std::make_index_sequence<std::size(kFixedRules)>());
+}
+
+// Реализации, которые поддерживает текущий процессор (от простой к самой быстрой)
+const std::vector<KernelInfo>& availableKernels();
+
+// Самое быстрое поддерживаемое ядро; выбирается один раз по CPUID
+const KernelInfo& activeKernel();
+
+// Соседи слова word строки row с запада и востока с учетом замыкания по горизонтали
+inline Grid::Word westNeighbors(const Grid::Word* row, int word, int words, int cols) {
+    Grid::Word carry = word > 0 ? row[word - 1] >> 63
+                                : (row[words - 1] >> ((cols - 1) % Grid::kWordBits)) & 1u;
+    return (row[word] << 1) | carry;
+}
+
+inline Grid::Word eastNeighbors(const Grid::Word* row, int word, int words, int cols) {
+    Grid::Word carry = word + 1 < words ? row[word + 1] << 63
+                                        : (row[0] & 1u) << ((cols - 1) % Grid::kWordBits);
+    return (row[word] >> 1) | carry;
+}
+
+#endif // LIFEKERNEL_H
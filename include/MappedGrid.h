@@ -0,0 +1,95 @@
+#ifndef MAPPEDGRID_H
+#define MAPPEDGRID_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "Grid.h"
+#include "LifeKernel.h"
+#include "ThreadPool.h"
+
+// Поле-тор вне оперативной памяти: два поколения лежат в файлах prefix.0.snap и prefix.1.snap,
+// отображенных в память (mmap). Шаг проходит поле полосами строк: следующая полоса заранее
+// запрашивается у ядра (MADV_WILLNEED), пройденные полосы освобождаются (MADV_DONTNEED), так что
+// в памяти одновременно находятся только несколько полос, а не все поле.
+// Файлы имеют формат двоичного снимка (без контрольной суммы): текущее поколение всегда
+// является готовым снимком, а сохранение в .snap копирует файл средствами ядра.
+// Ошибки выводятся в std::cerr, функции возвращают false.
+class MappedGrid {
+public:
+    MappedGrid() = default;
+    ~MappedGrid();
+
+    MappedGrid(const MappedGrid&) = delete;
+    MappedGrid& operator=(const MappedGrid&) = delete;
+
+    // Создать пустое поле rows x cols. Файлы создаются разреженными: мертвые клетки не занимают диск
+    bool create(const std::string& prefix, int rows, int cols);
+
+    // Создать поле по снимку: размер, правило и поколение берутся из него, слова копируются ядром
+    bool open(const std::string& prefix, const std::string& snapshotFilename);
+
+    // Добавить живые клетки из файла любого формата (см. readCells); клетки вне поля пропускаются
+    bool importCells(const std::string& filename);
+
+    bool get(int row, int col) const;
+    void set(int row, int col, bool alive);
+
+    int rows() const { return numRows; }
+    int cols() const { return numCols; }
+    const RuleMasks& rule() const { return ruleMasks; }
+    void setRule(const RuleMasks& rule) { ruleMasks = rule; }
+    std::uint64_t generation() const { return generationCount; }
+
+    // Сколько строк в полосе (по умолчанию около 8 МБ на полосу) и сколько потоков считают полосу
+    void setBandRows(int rows) { bandRows = rows > 0 ? rows : 1; }
+    void setThreads(int threads);
+
+    // Рассчитать generations поколений
+    void advance(std::uint64_t generations);
+
+    std::uint64_t population() const;
+
+    // Файл текущего поколения (готовый снимок)
+    const std::string& currentPath() const { return buffers[current].path; }
+
+    // Сохранить поле: .snap — копия файла текущего поколения, иначе Life 1.06 (потоком по строкам)
+    bool save(const std::string& filename, const std::string& name);
+
+    // Скопировать окно [0, rows) x [0, cols) поля grid
+    void copyToGrid(Grid& grid) const;
+
+private:
+    struct Buffer {
+        int fd = -1;
+        char* base = nullptr;
+        std::size_t length = 0;
+        std::string path;
+    };
+
+    bool map(Buffer& buffer, const std::string& path);
+    void close();
+    void writeHeader(Buffer& buffer);
+    void stepGeneration();
+
+    // Подсказать ядру о строках [rowBegin, rowEnd) буфера. Для MADV_DONTNEED границы сужаются
+    // до целых страниц (соседние строки еще нужны), для остальных подсказок — расширяются
+    void advise(const Buffer& buffer, long long rowBegin, long long rowEnd, int advice) const;
+
+    Grid::Word* rowData(Buffer& buffer, int row) const;
+    const Grid::Word* rowData(const Buffer& buffer, int row) const;
+
+    Buffer buffers[2];
+    int current = 0;
+    int numRows = 0;
+    int numCols = 0;
+    int rowWords = 0;
+    int bandRows = 0;
+    RuleMasks ruleMasks = ruleMasksFromString("B3/S23");
+    std::uint64_t generationCount = 0;
+    int numThreads = 1;
+    std::unique_ptr<ThreadPool> pool;
+};
+
+#endif // MAPPEDGRID_H
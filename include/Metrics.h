@@ -0,0 +1,100 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+// Метрики расчета: время фаз (шаг, вывод, сохранение, загрузка), число рассчитанных клеток,
+// сводка каждого поколения и число выделений памяти. Запись не выделяет память и не берет
+// блокировок. При сборке с GOL_METRICS=0 макросы и вызовы замеров исчезают из кода.
+#ifndef GOL_METRICS
+#define GOL_METRICS 0
+#endif
+
+enum class Phase { Step, Render, Save, Load, Count };
+
+// Сводка одного поколения
+struct GenerationStats {
+    long long iteration = 0;
+    std::uint64_t population = 0;
+    std::uint64_t births = 0;
+    std::uint64_t deaths = 0;
+    std::uint64_t stepNanoseconds = 0;
+};
+
+class Metrics {
+public:
+    static constexpr std::size_t kHistory = std::size_t(1) << 16; // Сколько последних поколений хранится
+
+    struct PhaseStats {
+        std::uint64_t count = 0;
+        std::uint64_t totalNanoseconds = 0;
+        std::uint64_t maxNanoseconds = 0;
+    };
+
+    void addTime(Phase phase, std::uint64_t nanoseconds);
+    void addCells(std::uint64_t cells) { cellsStepped.fetch_add(cells, std::memory_order_relaxed); }
+    void countAllocation() { allocations.fetch_add(1, std::memory_order_relaxed); }
+
+    // Запомнить сводку поколения (вызывается из одного потока — того, что ведет основную игру)
+    void recordGeneration(const GenerationStats& stats);
+
+    PhaseStats phase(Phase phase) const;
+    std::uint64_t allocationCount() const { return allocations.load(std::memory_order_relaxed); }
+    double cellsPerSecond() const;
+    std::size_t generationCount() const { return recorded < kHistory ? recorded : kHistory; }
+    const GenerationStats& generation(std::size_t index) const; // 0 — самое старое из хранимых
+
+    void reset();
+
+    // Сводка для команды stats, выгрузка в JSON и CSV (по строке на поколение)
+    void writeSummary(std::ostream& out) const;
+    void writeJson(std::ostream& out) const;
+    void writeCsv(std::ostream& out) const;
+
+private:
+    struct AtomicPhase {
+        std::atomic<std::uint64_t> count{0};
+        std::atomic<std::uint64_t> totalNanoseconds{0};
+        std::atomic<std::uint64_t> maxNanoseconds{0};
+    };
+
+    std::array<AtomicPhase, static_cast<std::size_t>(Phase::Count)> phases;
+    std::atomic<std::uint64_t> cellsStepped{0};
+    std::atomic<std::uint64_t> allocations{0};
+    std::array<GenerationStats, kHistory> history;
+    std::size_t recorded = 0;
+};
+
+// Общий набор метрик программы
+Metrics& metrics();
+
+// Замер времени блока: при выходе из области видимости время добавляется к фазе
+class ScopedTimer {
+public:
+    explicit ScopedTimer(Phase phase) : phase(phase), start(std::chrono::steady_clock::now()) {}
+    ~ScopedTimer() { metrics().addTime(phase, elapsedNanoseconds()); }
+
+    std::uint64_t elapsedNanoseconds() const {
+        return static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+
+private:
+    Phase phase;
+    std::chrono::steady_clock::time_point start;
+};
+
+#if GOL_METRICS
+#define GOL_METRICS_CONCAT_IMPL(a, b) a##b
+#define GOL_METRICS_CONCAT(a, b) GOL_METRICS_CONCAT_IMPL(a, b)
+#define GOL_SCOPED_TIMER(phase) ScopedTimer GOL_METRICS_CONCAT(golScopedTimer, __LINE__)(phase)
+#else
+#define GOL_SCOPED_TIMER(phase) ((void)0)
+#endif
+
+#endif // METRICS_H
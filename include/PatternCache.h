@@ -0,0 +1,61 @@
+#ifndef PATTERNCACHE_H
+#define PATTERNCACHE_H
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "Grid.h"
+#include "LifeKernel.h"
+
+// Кэш шаблонов (templates/) и правил (rules/): файлы читаются один раз, шаблоны сразу
+// упаковываются в битовое поле размером с их прямоугольник. Шаблон или правило, которого нет
+// в кэше (например, файл появился после запуска), читается с диска при первом обращении.
+class PatternCache {
+public:
+    struct RuleEntry {
+        std::string file; // Имя файла в каталоге правил
+        std::string text; // Первая строка файла (пустая, если файл пуст)
+    };
+
+    PatternCache(std::string templatesDir, std::string rulesDir);
+
+    // Упакованный шаблон по имени файла; nullptr, если файла нет. Указатель действителен всегда
+    const Grid* findTemplate(const std::string& name);
+
+    // Правило из файла по имени; false, если файла нет
+    bool findRule(const std::string& name, std::string& text);
+
+    // Имена шаблонов и правила, найденные в каталогах при загрузке (по алфавиту)
+    const std::vector<std::string>& templateNames() const { return names; }
+    const std::vector<RuleEntry>& rules() const { return ruleEntries; }
+
+    bool templatesFound() const { return templatesDirFound; }
+    bool rulesFound() const { return rulesDirFound; }
+
+private:
+    const Grid* loadTemplate(const std::string& name);
+
+    std::string templatesDir;
+    std::string rulesDir;
+    bool templatesDirFound = false;
+    bool rulesDirFound = false;
+    std::vector<std::string> names;
+    std::vector<RuleEntry> ruleEntries;
+    std::map<std::string, Grid> templates; // Узлы map не перемещаются: указатели на шаблоны стабильны
+    std::map<std::string, std::string> ruleTexts;
+    std::mutex mutex;
+};
+
+// Общий кэш каталогов templates/ и rules/ (загружается при первом обращении)
+PatternCache& patternCache();
+
+// Разобрать текстовый шаблон: 'O' — живая клетка, остальные символы — мертвые
+Grid parseTemplate(const std::string& text);
+
+// Наложить шаблон на поле по OR, левый верхний угол — (startRow, startCol).
+// Края замыкаются (тор), координаты могут быть любыми, в том числе отрицательными.
+// Шаблон накладывается словами, а не по клетке
+void blitPattern(Grid& grid, const Grid& pattern, int startRow, int startCol);
+
+#endif // PATTERNCACHE_H
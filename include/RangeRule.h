@@ -0,0 +1,65 @@
+#ifndef RANGERULE_H
+#define RANGERULE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Grid.h"
+#include "ThreadPool.h"
+
+// Правило Larger than Life: окрестность радиуса R (квадрат Мура или ромб фон Неймана),
+// рождение и выживание — диапазоны числа живых клеток в окрестности.
+// Запись как в Golly: R5,C0,M1,S34..58,B34..45,NM
+//   R — радиус, C — число состояний (поддерживаются только 0 и 2: клетка жива или мертва),
+//   M1 — сама клетка входит в окрестность, S и B — диапазоны min..max (или одно число),
+//   NM — окрестность Мура, NN — фон Неймана (по умолчанию NM)
+struct RangeRule {
+    enum class Neighborhood { Moore, VonNeumann };
+
+    static constexpr int kMaxRange = 100;
+
+    int range = 0; // 0 — правило не задано (действует обычное правило B/S)
+    bool countCenter = false;
+    Neighborhood neighborhood = Neighborhood::Moore;
+    int surviveMin = 0;
+    int surviveMax = -1;
+    int birthMin = 0;
+    int birthMax = -1;
+
+    bool active() const { return range > 0; }
+
+    // Число клеток окрестности (вместе с центральной, если M1) — наибольшее возможное число соседей
+    int cellCount() const;
+
+    bool operator==(const RangeRule& other) const;
+    bool operator!=(const RangeRule& other) const { return !(*this == other); }
+};
+
+// Разобрать правило вида R5,C0,M1,S34..58,B34..45,NM; false — строка не является таким правилом
+bool parseRangeRule(const std::string& text, RangeRule& rule);
+
+// Записать правило в том же виде
+std::string formatRangeRule(const RangeRule& rule);
+
+// Шаг правила Larger than Life на торе. Число соседей считается скользящими суммами, так что
+// время на клетку не зависит от R: для квадрата Мура — суммы по столбцам окна, сдвигаемые на строку,
+// и сумма окна по строке, сдвигаемая на столбец; для ромба фон Неймана окно сдвигается вдоль строки,
+// а входящая и уходящая границы ромба (по два диагональных отрезка) берутся из префиксных сумм
+// по диагоналям, построенных для полосы строк с запасом R сверху и снизу.
+// Если окрестность больше тора, клетки учитываются столько раз, сколько раз в нее попадают
+class RangeKernel {
+public:
+    void step(const Grid& current, Grid& next, const RangeRule& rule, ThreadPool* pool);
+
+private:
+    // Буферы одного потока: суммы по столбцам или префиксные суммы полосы
+    struct Scratch {
+        std::vector<std::uint32_t> columns;
+        std::vector<std::uint32_t> diagonal;
+        std::vector<std::uint32_t> antiDiagonal;
+    };
+
+    std::vector<Scratch> scratch;
+};
+
+#endif // RANGERULE_H
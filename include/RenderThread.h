@@ -0,0 +1,56 @@
+#ifndef RENDERTHREAD_H
+#define RENDERTHREAD_H
+
+#include <atomic>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <thread>
+#include "GameOfLife.h"
+#include "Renderer.h"
+#include "TripleBuffer.h"
+
+// Снимок поколения для вывода: поле и заголовок кадра
+struct RenderFrame {
+    Grid field;
+    std::string header;
+};
+
+// Вывод кадров в отдельном потоке. Расчет публикует поколения через тройной буфер и не ждет
+// терминал; поток вывода показывает самое свежее поколение не чаще ограничения частоты кадров
+// renderer, промежуточные поколения пропускаются. Поле копируется только тогда, когда поток
+// вывода готов к следующему кадру, так что показанный кадр отстает от расчета не больше чем
+// на одно поколение после ожидания кадра.
+// Пока поток работает, renderer и out принадлежат ему: другой вывод в out возможен после finish.
+class RenderThread {
+public:
+    RenderThread(TerminalRenderer& renderer, std::ostream& out);
+    ~RenderThread();
+
+    RenderThread(const RenderThread&) = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+
+    // Опубликовать текущее поколение игры, если поток вывода ждет кадр (или force — например,
+    // для последнего поколения, которое должно быть показано). true — поколение опубликовано
+    bool publish(const Game& game, bool force = false);
+
+    // Показать последний опубликованный кадр и остановить поток
+    void finish();
+
+    std::size_t publishedFrames() const { return published; }
+    std::size_t shownFrames() const { return shown.load(std::memory_order_relaxed); }
+
+private:
+    void run();
+
+    TerminalRenderer& renderer;
+    std::ostream& out;
+    TripleBuffer<RenderFrame> frames;
+    std::atomic<bool> wantFrame{true};
+    std::atomic<bool> stopping{false};
+    std::size_t published = 0;
+    std::atomic<std::size_t> shown{0};
+    std::thread thread;
+};
+
+#endif // RENDERTHREAD_H
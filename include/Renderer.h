@@ -0,0 +1,70 @@
+#ifndef RENDERER_H
+#define RENDERER_H
+
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include "GameOfLife.h"
+
+// Вывод поля в терминал через ANSI-последовательности.
+// Кадр собирается в одном буфере, память которого переиспользуется между кадрами, и выводится
+// одной записью. После первого кадра перерисовываются только строки экрана, клетки которых
+// изменились; курсор ставится на нужную строку напрямую, без очистки экрана.
+class TerminalRenderer {
+public:
+    // Способ вывода клеток: символ на клетку, полублоки (2 клетки по вертикали)
+    // или шрифт Брайля (2x4 клетки на символ)
+    enum class Glyphs { Ascii, HalfBlock, Braille };
+
+    // maxFps — ограничение частоты кадров для waitForNextFrame (0 — без ограничения)
+    explicit TerminalRenderer(Glyphs glyphs = Glyphs::Ascii, double maxFps = 0) : glyphs(glyphs), maxFps(maxFps) {}
+
+    void setGlyphs(Glyphs newGlyphs);
+    void setMaxFps(double fps) { maxFps = fps; }
+
+    // Разобрать имя способа вывода: ascii, half или braille
+    static bool parseGlyphs(const std::string& name, Glyphs& result);
+
+    // Собрать кадр: после invalidate (и в первый раз) — весь экран, иначе только изменившиеся строки
+    const std::string& renderFrame(const Game& game);
+
+    // То же для снимка поколения: поле и заголовок, заранее собранный appendHeader
+    const std::string& renderFrame(const Grid& grid, const std::string& frameHeader);
+
+    // Собрать кадр и вывести его одной записью
+    void draw(const Game& game, std::ostream& out);
+    void draw(const Grid& grid, const std::string& frameHeader, std::ostream& out);
+
+    // Заголовок кадра: имя игры, правило и номер поколения
+    static void appendHeader(const Game& game, std::string& out);
+    // То же с другим номером поколения (кадры из истории)
+    static void appendHeader(const Game& game, long long iteration, std::string& out);
+
+    // Следующий кадр перерисовать целиком (например, после другого вывода в терминал)
+    void invalidate() { fullRedraw = true; }
+
+    // Дождаться времени следующего кадра с учетом ограничения частоты
+    void waitForNextFrame();
+
+    // Сколько строк поля было выведено в последнем кадре
+    std::size_t redrawnRows() const { return lastRedrawnRows; }
+
+private:
+    int cellsPerLine() const { return glyphs == Glyphs::Braille ? 2 : 1; }
+    int rowsPerLine() const { return glyphs == Glyphs::Ascii ? 1 : glyphs == Glyphs::HalfBlock ? 2 : 4; }
+    const std::string& renderGrid(const Grid& grid); // Кадр по полю и уже собранному header
+    void appendFieldLine(const Grid& grid, int line, int width);
+
+    Glyphs glyphs;
+    double maxFps;
+    std::string frame;           // Буфер кадра
+    std::string header;          // Заголовок текущего и прошлого кадров
+    std::string previousHeader;
+    Grid shown;                  // Поле, выведенное в прошлом кадре
+    bool fullRedraw = true;
+    std::size_t lastRedrawnRows = 0;
+    std::chrono::steady_clock::time_point nextFrameTime;
+};
+
+#endif // RENDERER_H
@@ -0,0 +1,49 @@
+#ifndef RULESWEEP_H
+#define RULESWEEP_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "Grid.h"
+#include "LifeKernel.h"
+
+// Перебор правил и начальных состояний: каждое правило запускается на случайных полях
+// с заданными зернами до предела поколений, по каждому прогону собирается строка итогов.
+// Маленькие независимые поля считаются пачками в потоках, каждое — напрямую ядром шага
+// без вывода и учета активности. Прогон останавливается досрочно, когда поле вымерло
+// или состояние повторилось: остаток до предела досчитывается по найденному периоду.
+
+struct SweepOptions {
+    int rows = 25;              // Размер поля (по умолчанию как в интерактивном режиме)
+    int cols = 50;
+    long long generations = 1000; // Предел поколений
+    double density = 0.35;      // Доля живых клеток в начальном поле
+};
+
+// Итоги одного прогона
+struct SweepRun {
+    RuleMasks rule;
+    unsigned seed = 0;
+    std::uint64_t population = 0; // Население на последнем поколении
+    long long period = 0;         // Период найденного цикла (0 — не найден в пределах истории)
+    long long cycleStart = 0;     // Поколение, с которого состояние повторяется
+    long long extinction = -1;    // Поколение, в котором поле вымерло (-1 — не вымерло)
+};
+
+// Набор правил по описанию: "rules" — правила из файлов каталога rules/, "all" — все 2^18
+// сочетаний B/S, иначе список правил через запятую ("B3/S23,B36/S23"). false — ошибка в описании.
+bool sweepRules(const std::string& spec, std::vector<RuleMasks>& rules, std::ostream& errors);
+
+// Случайное поле по зерну: одно зерно всегда дает одно и то же поле
+void fillSoup(Grid& grid, unsigned seed, double density);
+
+// Выполнить все сочетания правил и зерен в threads потоков. Результаты идут в порядке
+// "правило, затем зерно" независимо от числа потоков
+std::vector<SweepRun> runSweep(const std::vector<RuleMasks>& rules, const std::vector<unsigned>& seeds,
+                               const SweepOptions& options, int threads);
+
+// Таблица итогов: по строке на прогон
+void writeSweepTable(const std::vector<SweepRun>& runs, std::ostream& out);
+
+#endif // RULESWEEP_H
@@ -0,0 +1,113 @@
+#ifndef SIMULATIONWORKER_H
+#define SIMULATIONWORKER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include "GameOfLife.h"
+#include "TripleBuffer.h"
+
+// Согласованный снимок поколения для команд status и dump
+struct SimulationSnapshot {
+    Grid field;
+    long long generation = 0;
+};
+
+// Расчет игры в отдельном потоке, которым командный цикл управляет через очередь команд:
+// run — считать без остановки, step N — досчитать N поколений, pause — остановиться.
+// Команды выполняются между поколениями, командный цикл их не ждет (кроме pause и call).
+// Пока поток работает, игра принадлежит ему: все остальное, что читает или меняет игру
+// (загрузка шаблона, вывод кадров, сохранение метрик), выполняется через call в потоке расчета.
+// Снимок поля для status и dump во время расчета — поколение, вытесненное очередным шагом: поток
+// расчета меняет его буфер местами со слотом тройного буфера и отдает слот обменом, поле не копируется.
+// Когда расчет стоит, поле под блокировкой копирует сам командный цикл. Файл записывается
+// в командном цикле, пока расчет продолжается.
+class SimulationWorker {
+public:
+    struct Status {
+        long long generation = 0;        // Номер текущего поколения
+        double generationsPerSecond = 0; // Скорость текущего (или последнего) непрерывного расчета
+        bool running = false;            // Идет run
+        long long pendingSteps = 0;      // Сколько поколений осталось от step N
+    };
+
+    // afterGeneration вызывается в потоке расчета после каждого поколения (контрольные точки, история)
+    explicit SimulationWorker(Game& game, std::function<void(Game&)> afterGeneration = {});
+    ~SimulationWorker();
+
+    SimulationWorker(const SimulationWorker&) = delete;
+    SimulationWorker& operator=(const SimulationWorker&) = delete;
+
+    void run();
+    void step(long long generations);
+    void pause(); // Остановить run и step и дождаться конца текущего поколения
+
+    // Выполнить action над игрой в потоке расчета между поколениями и дождаться его завершения.
+    // Расчет по run и step после этого продолжается
+    void call(std::function<void(Game&)> action);
+
+    // Дождаться, пока закончатся поколения step N (при run ждет до pause из другого потока)
+    void waitIdle();
+
+    // Согласованный снимок: во время расчета — поколение, предшествующее последнему рассчитанному,
+    // иначе текущее. Действителен до следующего вызова snapshot
+    const SimulationSnapshot& snapshot();
+
+    Status status();
+
+    // Остановить поток расчета (вызывается и деструктором)
+    void stop();
+
+private:
+    struct Command {
+        enum class Kind { Run, Step, Pause, Call, Stop };
+
+        explicit Command(Kind kind, long long steps = 0, std::function<void(Game&)> action = {})
+            : kind(kind), steps(steps), action(std::move(action)) {}
+
+        Kind kind;
+        long long steps = 0;
+        std::function<void(Game&)> action;
+        std::uint64_t id = 0;
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    // Поставить команду в очередь; возвращает ее номер для ожидания выполнения
+    std::uint64_t enqueue(Command command);
+    void waitFor(std::uint64_t id);
+    void loop();
+    bool busy() const { return running || pendingSteps > 0; }
+
+    Game& game;
+    std::function<void(Game&)> afterGeneration;
+
+    std::mutex mutex;
+    std::condition_variable wake; // Новая команда
+    std::condition_variable done; // Команда выполнена, снимок готов или расчет остановился
+    std::deque<Command> commands;
+    std::uint64_t issued = 0;
+    std::uint64_t completed = 0;
+    bool running = false;
+    long long pendingSteps = 0;
+    bool stopped = false;
+    bool snapshotRequested = false;
+    bool working = false; // Поток расчета считает поколение или выполняет call без блокировки
+    long long generation = 0;
+
+    // Скорость считается от начала непрерывного расчета; после остановки хранится последняя
+    bool wasBusy = false;
+    Clock::time_point startTime;
+    long long startGeneration = 0;
+    double lastRate = 0;
+
+    TripleBuffer<SimulationSnapshot> snapshots;
+    std::thread thread;
+};
+
+#endif // SIMULATIONWORKER_H
@@ -0,0 +1,56 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Постоянный пул потоков для параллельных циклов.
+// Потоки создаются один раз в конструкторе и ждут заданий, поэтому на каждое
+// поколение не создается ни одного потока. parallelFor возвращает управление только
+// после завершения всех задач, то есть служит барьером между поколениями.
+class ThreadPool {
+public:
+    // threads — общее число потоков, включая вызывающий
+    explicit ThreadPool(int threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int size() const { return static_cast<int>(workers.size()) + 1; }
+
+    // Выполнить task(index) для всех index из [0, tasks) и дождаться завершения.
+    // Не выделяет память: задача передается через указатель на вызываемый объект.
+    template <typename Task>
+    void parallelFor(int tasks, Task&& task) {
+        using TaskType = std::remove_reference_t<Task>;
+        run(tasks, [](void* context, int index) { (*static_cast<TaskType*>(context))(index); }, &task);
+    }
+
+private:
+    using TaskFunction = void (*)(void* context, int index);
+
+    void run(int tasks, TaskFunction function, void* context);
+    void workerLoop();
+    void drainTasks();
+
+    std::vector<std::thread> workers;
+    std::mutex runMutex;            // Одновременно выполняется только один parallelFor
+    std::mutex stateMutex;
+    std::condition_variable wakeWorkers;
+    std::condition_variable allDone;
+
+    TaskFunction currentFunction = nullptr;
+    void* currentContext = nullptr;
+    int taskCount = 0;
+    std::atomic<int> nextTask{0};
+    std::atomic<int> pendingTasks{0};
+    int activeWorkers = 0;          // Потоки, которые сейчас разбирают задачи
+    unsigned long long epoch = 0;   // Номер текущего задания, по нему потоки узнают о новой работе
+    bool stopping = false;
+};
+
+#endif // THREADPOOL_H
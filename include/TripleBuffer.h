@@ -0,0 +1,43 @@
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <array>
+#include <atomic>
+
+// Тройной буфер: передача последнего значения от одного потока-писателя одному потоку-читателю
+// без блокировок и ожидания. У писателя и читателя по своему слоту, третий слот — промежуточный.
+// Писатель заполняет свой слот и обменивает его с промежуточным, читатель забирает промежуточный,
+// если туда положили новое значение. Значения, которые читатель не успел забрать, перезаписываются,
+// поэтому читатель всегда получает самое свежее, а писатель никогда не ждет читателя.
+template <typename T>
+class TripleBuffer {
+public:
+    // Слот писателя: заполнить и вызвать publish
+    T& writeSlot() { return slots[writeIndex]; }
+
+    void publish() {
+        writeIndex = middle.exchange(writeIndex | kFresh, std::memory_order_acq_rel) & kIndexMask;
+    }
+
+    // Забрать самое свежее значение в слот читателя; false — новых значений не было
+    bool consume() {
+        if ((middle.load(std::memory_order_relaxed) & kFresh) == 0) {
+            return false;
+        }
+        readIndex = middle.exchange(readIndex, std::memory_order_acq_rel) & kIndexMask;
+        return true;
+    }
+
+    const T& readSlot() const { return slots[readIndex]; }
+
+private:
+    static constexpr unsigned kIndexMask = 3;
+    static constexpr unsigned kFresh = 4; // В промежуточном слоте значение, которое читатель еще не видел
+
+    std::array<T, 3> slots;
+    unsigned writeIndex = 0;               // Меняется только писателем
+    unsigned readIndex = 1;                // Меняется только читателем
+    std::atomic<unsigned> middle{2};       // Номер промежуточного слота и признак kFresh
+};
+
+#endif // TRIPLEBUFFER_H
@@ -0,0 +1,61 @@
+#include "include/ActivityTracker.h"
+#include <algorithm>
+
+void ActivityTracker::reset(int rows, int cols) {
+    numRows = rows;
+    numCols = cols;
+    numTileRows = (rows + kTileRows - 1) / kTileRows;
+    numTileCols = (cols + 63) / 64;
+
+    std::size_t tiles = static_cast<std::size_t>(numTileRows) * numTileCols;
+    changed.assign(tiles, 1);
+    nextChanged.assign(tiles, 0);
+    // В ряду не больше отрезков, чем плиток, поэтому память на шаге не выделяется
+    runs.reserve(tiles);
+    runOffsets.assign(numTileRows + 1, 0);
+    activeTiles = tiles;
+}
+
+void ActivityTracker::invalidate() {
+    std::fill(changed.begin(), changed.end(), 1);
+}
+
+void ActivityTracker::beginStep() {
+    runs.clear();
+    activeTiles = 0;
+
+    for (int tileRow = 0; tileRow < numTileRows; ++tileRow) {
+        runOffsets[tileRow] = static_cast<int>(runs.size());
+        const std::uint8_t* rowsAround[3] = {
+            &changed[static_cast<std::size_t>(tileRow == 0 ? numTileRows - 1 : tileRow - 1) * numTileCols],
+            &changed[static_cast<std::size_t>(tileRow) * numTileCols],
+            &changed[static_cast<std::size_t>(tileRow == numTileRows - 1 ? 0 : tileRow + 1) * numTileCols],
+        };
+
+        int runStart = -1;
+        for (int tileCol = 0; tileCol < numTileCols; ++tileCol) {
+            int west = tileCol == 0 ? numTileCols - 1 : tileCol - 1;
+            int east = tileCol == numTileCols - 1 ? 0 : tileCol + 1;
+            bool active = false;
+            for (const std::uint8_t* flags : rowsAround) {
+                active = active || flags[west] || flags[tileCol] || flags[east];
+            }
+
+            if (active) {
+                ++activeTiles;
+                if (runStart < 0) {
+                    runStart = tileCol;
+                }
+            } else if (runStart >= 0) {
+                runs.emplace_back(runStart, tileCol);
+                runStart = -1;
+            }
+        }
+        if (runStart >= 0) {
+            runs.emplace_back(runStart, numTileCols);
+        }
+    }
+    runOffsets[numTileRows] = static_cast<int>(runs.size());
+
+    std::fill(nextChanged.begin(), nextChanged.end(), 0);
+}
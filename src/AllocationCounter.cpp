@@ -0,0 +1,22 @@
+#include "include/Metrics.h"
+#include <cstdlib>
+#include <new>
+
+// Подсчет выделений памяти для метрик: глобальный operator new программы game.
+// Файл входит только в исполняемый файл игры, чтобы не мешать своим счетчикам в тестах.
+
+void* operator new(std::size_t size) {
+    metrics().countAllocation();
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
@@ -0,0 +1,160 @@
+#include "include/BatchRunner.h"
+#include "include/GameOfLife.h"
+#include "include/ThreadPool.h"
+#include "include/RangeRule.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Правило вида B<цифры 0-8>/S<цифры 0-8> или Larger than Life (R5,C0,M1,S34..58,B34..45,NM)
+bool isValidRule(const std::string& rule) {
+    RangeRule range;
+    if (parseRangeRule(rule, range)) {
+        return true;
+    }
+    std::size_t slash = rule.find('/');
+    if (rule.size() < 3 || rule[0] != 'B' || slash == std::string::npos || slash + 1 >= rule.size() ||
+        rule[slash + 1] != 'S') {
+        return false;
+    }
+    for (std::size_t i = 1; i < rule.size(); ++i) {
+        if (i != slash && i != slash + 1 && (rule[i] < '0' || rule[i] > '8')) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string formatSummary(std::size_t index, std::size_t total, const BatchJob& job, const BatchResult& result) {
+    std::ostringstream line;
+    line << "[" << index + 1 << "/" << total << "] " << job.input;
+    if (!result.ok) {
+        line << ": error: " << result.error;
+        return line.str();
+    }
+    double cellsPerSecond = result.stepSeconds > 0
+                                ? static_cast<double>(result.rows) * result.cols * job.iterations / result.stepSeconds
+                                : 0;
+    line << " -> " << job.output << ": " << job.iterations << " generations, population " << result.population
+         << std::fixed << std::setprecision(3) << ", load " << result.loadSeconds * 1000 << " ms, step "
+         << result.stepSeconds * 1000 << " ms, save " << result.saveSeconds * 1000 << " ms"
+         << std::scientific << std::setprecision(2) << ", " << cellsPerSecond << " cells/s";
+    return line.str();
+}
+
+} // namespace
+
+bool readBatchManifest(const std::string& filename, std::vector<BatchJob>& jobs, std::ostream& errors) {
+    std::ifstream manifest(filename);
+    if (!manifest.is_open()) {
+        errors << "Error: Unable to open batch manifest '" << filename << "'" << std::endl;
+        return false;
+    }
+
+    bool valid = true;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(manifest, line)) {
+        ++lineNumber;
+        std::size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') {
+            continue;
+        }
+
+        std::istringstream fields(line);
+        BatchJob job;
+        job.line = lineNumber;
+        if (!(fields >> job.input >> job.rule >> job.iterations >> job.output) || job.iterations < 0 ||
+            (job.rule != "-" && !isValidRule(job.rule))) {
+            errors << filename << ":" << lineNumber << ": expected 'input rule iterations output [rows cols]'"
+                   << std::endl;
+            valid = false;
+            continue;
+        }
+        if (fields >> job.rows) {
+            if (!(fields >> job.cols) || job.rows <= 0 || job.cols <= 0) {
+                errors << filename << ":" << lineNumber << ": invalid field size" << std::endl;
+                valid = false;
+                continue;
+            }
+        }
+        jobs.push_back(job);
+    }
+    return valid;
+}
+
+BatchResult runBatchJob(const BatchJob& job) {
+    BatchResult result;
+    Game game(job.input, job.rows, job.cols);
+    game.verbose = false;
+
+    Clock::time_point start = Clock::now();
+    if (!game.readFromFile(job.input)) {
+        result.error = "unable to open input file";
+        return result;
+    }
+    // Правило из манифеста задается после чтения: заголовки RLE и снимков иначе заменили бы его
+    if (job.rule != "-") {
+        game.parseRules(job.rule);
+    }
+    result.rows = game.field.rows();
+    result.cols = game.field.cols();
+    result.loadSeconds = secondsSince(start);
+
+    start = Clock::now();
+    for (long long i = 0; i < job.iterations; ++i) {
+        game.calculateNextState();
+    }
+    result.stepSeconds = secondsSince(start);
+    result.population = game.field.population();
+
+    if (job.output != "-") {
+        start = Clock::now();
+        if (!game.saveToFile(job.output)) {
+            result.error = "unable to write output file '" + job.output + "'";
+            return result;
+        }
+        result.saveSeconds = secondsSince(start);
+    }
+
+    result.ok = true;
+    return result;
+}
+
+int runBatch(const std::vector<BatchJob>& jobs, int threads, std::ostream& out) {
+    std::mutex outMutex;
+    int failed = 0;
+
+    // Каждое задание считается в одном потоке: параллельность дают сами независимые задания
+    auto runJob = [&](int index) {
+        BatchResult result = runBatchJob(jobs[index]);
+        std::string summary = formatSummary(index, jobs.size(), jobs[index], result);
+
+        std::lock_guard<std::mutex> lock(outMutex);
+        if (!result.ok) {
+            ++failed;
+        }
+        out << summary << std::endl;
+    };
+
+    if (threads > 1 && jobs.size() > 1) {
+        ThreadPool pool(std::min<int>(threads, static_cast<int>(jobs.size())));
+        pool.parallelFor(static_cast<int>(jobs.size()), runJob);
+    } else {
+        for (std::size_t i = 0; i < jobs.size(); ++i) {
+            runJob(static_cast<int>(i));
+        }
+    }
+    return failed;
+}
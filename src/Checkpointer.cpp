@@ -0,0 +1,126 @@
+#include "include/Checkpointer.h"
+#include "include/LifeFile.h"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+Checkpointer::Checkpointer(std::string prefix, int keep)
+    : prefix(std::move(prefix)), keep(static_cast<std::size_t>(std::max(keep, 1))) {
+    // Точки прошлого запуска участвуют в ротации наравне с новыми
+    files = list(this->prefix);
+    writer = std::thread([this] { writerLoop(); });
+}
+
+Checkpointer::~Checkpointer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeWriter.notify_one();
+    writer.join();
+}
+
+void Checkpointer::submit(const Grid& grid, const RuleMasks& rule, std::uint64_t generation) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (hasPending) {
+            ++dropped;
+        }
+        // Копирование в буфер того же размера не выделяет память
+        pending.grid = grid;
+        pending.rule = rule;
+        pending.generation = generation;
+        hasPending = true;
+    }
+    wakeWriter.notify_one();
+}
+
+void Checkpointer::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this] { return !hasPending && !busy; });
+}
+
+std::size_t Checkpointer::writtenCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return written;
+}
+
+std::size_t Checkpointer::droppedCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return dropped;
+}
+
+void Checkpointer::writerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wakeWriter.wait(lock, [this] { return hasPending || stopping; });
+        if (!hasPending) {
+            return; // Остановка: все переданные точки уже записаны
+        }
+        // Буферы меняются местами без копирования, дальше запись идет без блокировки
+        std::swap(pending, writing);
+        hasPending = false;
+        busy = true;
+        lock.unlock();
+
+        // Запись во временный файл и переименование: оборванная запись не портит последнюю точку
+        std::string path = prefix + "." + std::to_string(writing.generation) + ".snap";
+        std::string temporary = path + ".tmp";
+        bool saved = writeSnapshot(temporary, writing.grid, writing.rule, writing.generation) &&
+                     std::rename(temporary.c_str(), path.c_str()) == 0;
+        if (saved) {
+            files.erase(std::remove_if(files.begin(), files.end(),
+                                       [&](const auto& file) { return file.first == writing.generation; }),
+                        files.end());
+            files.emplace_back(writing.generation, path);
+            std::sort(files.begin(), files.end());
+            while (files.size() > keep) {
+                std::remove(files.front().second.c_str());
+                files.erase(files.begin());
+            }
+        } else {
+            std::remove(temporary.c_str());
+            std::cerr << "Error: Unable to write checkpoint '" << path << "'" << std::endl;
+        }
+
+        lock.lock();
+        busy = false;
+        if (saved) {
+            ++written;
+        }
+        if (!hasPending) {
+            idle.notify_all();
+        }
+    }
+}
+
+std::vector<std::pair<std::uint64_t, std::string>> Checkpointer::list(const std::string& prefix) {
+    std::vector<std::pair<std::uint64_t, std::string>> found;
+    fs::path base(prefix);
+    fs::path directory = base.has_parent_path() ? base.parent_path() : fs::path(".");
+    std::string stem = base.filename().string() + ".";
+
+    std::error_code error;
+    for (const auto& entry : fs::directory_iterator(directory, error)) {
+        std::string name = entry.path().filename().string();
+        if (!entry.is_regular_file() || name.size() <= stem.size() + 5 || name.compare(0, stem.size(), stem) != 0 ||
+            name.compare(name.size() - 5, 5, ".snap") != 0) {
+            continue;
+        }
+        std::string digits = name.substr(stem.size(), name.size() - stem.size() - 5);
+        if (digits.find_first_not_of("0123456789") != std::string::npos) {
+            continue;
+        }
+        found.emplace_back(std::stoull(digits), (directory / name).string());
+    }
+    std::sort(found.begin(), found.end());
+    return found;
+}
+
+std::string Checkpointer::latest(const std::string& prefix) {
+    auto found = list(prefix);
+    return found.empty() ? std::string() : found.back().second;
+}
@@ -0,0 +1,56 @@
+#include "include/CycleDetector.h"
+#include <algorithm>
+
+std::uint64_t gridHash(const Grid& grid) {
+    const Grid::Word* words = grid.data();
+    std::uint64_t hash = 0;
+    for (std::size_t i = 0; i < grid.wordCount(); ++i) {
+        hash ^= gridWordHash(words[i], i);
+    }
+    return hash;
+}
+
+CycleDetector::CycleDetector(std::size_t historySize)
+    : history(static_cast<long long>(std::max<std::size_t>(historySize, 1))) {
+    // Заполнение таблицы живыми записями не выше четверти
+    std::size_t slots = 64;
+    while (slots < 4 * historySize) {
+        slots *= 2;
+    }
+    table.assign(slots, Entry{0, kEmpty});
+    mask = slots - 1;
+}
+
+void CycleDetector::clear() {
+    std::fill(table.begin(), table.end(), Entry{0, kEmpty});
+    foundPeriod = 0;
+    foundStart = 0;
+}
+
+bool CycleDetector::record(std::uint64_t hash, long long generation) {
+    const long long oldest = generation - history;
+    std::size_t start = static_cast<std::size_t>(hash ^ (hash >> 29)) & mask;
+
+    // Свободное место для записи: совпадающая запись, устаревшая или самая старая в окне поиска
+    Entry* target = nullptr;
+    for (std::size_t probe = 0; probe < kProbeLimit; ++probe) {
+        Entry& entry = table[(start + probe) & mask];
+        bool live = entry.generation >= oldest && entry.generation < generation;
+        if (live && entry.hash == hash) {
+            foundPeriod = generation - entry.generation;
+            foundStart = entry.generation;
+            entry.generation = generation;
+            return true;
+        }
+        if (!live) {
+            if (target == nullptr || target->generation >= oldest) {
+                target = &entry;
+            }
+        } else if (target == nullptr || (target->generation >= oldest && entry.generation < target->generation)) {
+            target = &entry;
+        }
+    }
+    target->hash = hash;
+    target->generation = generation;
+    return false;
+}
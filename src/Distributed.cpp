@@ -0,0 +1,440 @@
+#include "include/Distributed.h"
+#include "include/LifeFile.h"
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr std::size_t kChunkWords = std::size_t(1) << 17; // 1 МБ на проход контрольной суммы
+
+// Обмен одной строкой с соседом по неблокирующему сокету: своя строка уходит, строка соседа приходит
+struct Channel {
+    int fd = -1;
+    const char* sendData = nullptr;
+    std::size_t sendLeft = 0;
+    char* receiveData = nullptr;
+    std::size_t receiveLeft = 0;
+};
+
+// Продвинуть обмен, не блокируясь. false — сосед закрыл соединение или произошла ошибка
+bool progress(Channel* channels, int count) {
+    for (int i = 0; i < count; ++i) {
+        Channel& channel = channels[i];
+        while (channel.sendLeft > 0) {
+            ssize_t sent = ::send(channel.fd, channel.sendData, channel.sendLeft, MSG_DONTWAIT | MSG_NOSIGNAL);
+            if (sent < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+                    break;
+                }
+                return false;
+            }
+            channel.sendData += sent;
+            channel.sendLeft -= static_cast<std::size_t>(sent);
+        }
+        while (channel.receiveLeft > 0) {
+            ssize_t received = ::recv(channel.fd, channel.receiveData, channel.receiveLeft, MSG_DONTWAIT);
+            if (received == 0) {
+                return false;
+            }
+            if (received < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+                    break;
+                }
+                return false;
+            }
+            channel.receiveData += received;
+            channel.receiveLeft -= static_cast<std::size_t>(received);
+        }
+    }
+    return true;
+}
+
+// Дождаться завершения обмена
+bool finish(Channel* channels, int count) {
+    while (true) {
+        if (!progress(channels, count)) {
+            return false;
+        }
+        pollfd fds[2];
+        int waiting = 0;
+        for (int i = 0; i < count; ++i) {
+            short events = static_cast<short>((channels[i].sendLeft > 0 ? POLLOUT : 0) |
+                                              (channels[i].receiveLeft > 0 ? POLLIN : 0));
+            if (events != 0) {
+                fds[waiting++] = {channels[i].fd, events, 0};
+            }
+        }
+        if (waiting == 0) {
+            return true;
+        }
+        if (::poll(fds, static_cast<nfds_t>(waiting), -1) < 0 && errno != EINTR) {
+            return false;
+        }
+    }
+}
+
+// Прочитать ровно bytes байт (offset < 0 — с текущей позиции канала)
+bool readExact(int fd, char* data, std::size_t bytes, off_t offset = -1) {
+    while (bytes > 0) {
+        ssize_t done = offset < 0 ? ::read(fd, data, bytes) : ::pread(fd, data, bytes, offset);
+        if (done < 0 && errno == EINTR) {
+            continue;
+        }
+        if (done <= 0) {
+            return false;
+        }
+        data += done;
+        bytes -= static_cast<std::size_t>(done);
+        if (offset >= 0) {
+            offset += done;
+        }
+    }
+    return true;
+}
+
+// Записать ровно bytes байт (offset < 0 — в текущую позицию канала)
+bool writeExact(int fd, const char* data, std::size_t bytes, off_t offset = -1) {
+    while (bytes > 0) {
+        ssize_t done = offset < 0 ? ::write(fd, data, bytes) : ::pwrite(fd, data, bytes, offset);
+        if (done < 0 && errno == EINTR) {
+            continue;
+        }
+        if (done <= 0) {
+            return false;
+        }
+        data += done;
+        bytes -= static_cast<std::size_t>(done);
+        if (offset >= 0) {
+            offset += done;
+        }
+    }
+    return true;
+}
+
+// Откуда процессы берут начальные полосы и куда отдают итоговые
+struct StripeIo {
+    // В дочернем процессе: прочитать строки [rowBegin, rowEnd) в words
+    std::function<bool(int rowBegin, int rowEnd, Grid::Word* words)> load;
+    // В дочернем процессе: отдать итоговые строки; resultFd — канал к родителю (если есть collect)
+    std::function<bool(int rowBegin, int rowEnd, const Grid::Word* words, int resultFd)> store;
+    // В родителе: принять итоговые строки процесса из канала. Пусто — полосы пишутся в файл и канал не нужен
+    std::function<bool(int rowBegin, int rowEnd, int resultFd)> collect;
+};
+
+// Работа одного процесса: в памяти только своя полоса [rowBegin, rowEnd) с гало сверху и снизу
+bool runWorker(int cols, const RuleMasks& rule, long long generations, int rowBegin, int rowEnd, int upFd, int downFd,
+               const StripeIo& io, int resultFd) {
+    const int rows = rowEnd - rowBegin;
+    const RowKernel kernel = activeKernel().select(rule);
+
+    // Строка 0 — гало сверху, строки 1..rows — своя полоса, строка rows + 1 — гало снизу
+    Grid current(rows + 2, cols);
+    Grid next(rows + 2, cols);
+    const int words = current.wordsPerRow();
+    const std::size_t rowBytes = static_cast<std::size_t>(words) * sizeof(Grid::Word);
+    if (!io.load(rowBegin, rowEnd, current.rowData(1))) {
+        return false;
+    }
+
+    auto stepRow = [&](int row) {
+        kernel(current.rowData(row - 1), current.rowData(row), current.rowData(row + 1), next.rowData(row), cols, 0,
+               words, rule);
+    };
+    for (long long generation = 0; generation < generations; ++generation) {
+        // Своя верхняя строка уходит соседу сверху, его нижняя приходит в гало сверху; снизу наоборот
+        Channel channels[2];
+        channels[0] = {upFd, reinterpret_cast<const char*>(current.rowData(1)), rowBytes,
+                       reinterpret_cast<char*>(current.rowData(0)), rowBytes};
+        channels[1] = {downFd, reinterpret_cast<const char*>(current.rowData(rows)), rowBytes,
+                       reinterpret_cast<char*>(current.rowData(rows + 1)), rowBytes};
+        if (!progress(channels, 2)) {
+            return false;
+        }
+
+        // Внутренние строки не зависят от гало и считаются, пока идет обмен
+        for (int row = 2; row < rows; ++row) {
+            stepRow(row);
+            if ((row & 15) == 0 && !progress(channels, 2)) {
+                return false;
+            }
+        }
+        if (!finish(channels, 2)) {
+            return false;
+        }
+        stepRow(1);
+        if (rows > 1) {
+            stepRow(rows);
+        }
+        current.swap(next);
+    }
+
+    return io.store(rowBegin, rowEnd, std::as_const(current).rowData(1), resultFd);
+}
+
+// Запустить процессы, дождаться их и собрать итог. Полоса процесса i — строки
+// [rows * i / workers, rows * (i + 1) / workers)
+bool runWorkers(int rows, int cols, const RuleMasks& rule, long long generations, int workers, const StripeIo& io) {
+    auto rowBegin = [&](int worker) { return static_cast<int>(static_cast<long long>(rows) * worker / workers); };
+
+    // Связь i соединяет нижний край процесса i с верхним краем процесса i + 1 (последний — с первым).
+    // Если итог собирает родитель, у каждого процесса есть еще канал к нему
+    std::vector<int> downFds(workers, -1), upFds(workers, -1), resultReadFds(workers, -1), resultWriteFds(workers, -1);
+    auto closeAll = [](std::vector<int>& fds, int keep) {
+        for (int i = 0; i < static_cast<int>(fds.size()); ++i) {
+            if (i != keep && fds[i] >= 0) {
+                ::close(fds[i]);
+                fds[i] = -1;
+            }
+        }
+    };
+
+    bool ok = true;
+    for (int i = 0; i < workers && ok; ++i) {
+        int pair[2];
+        if (::socketpair(AF_UNIX, SOCK_STREAM, 0, pair) != 0) {
+            std::cerr << "Error: Unable to create socket pair: " << std::strerror(errno) << std::endl;
+            ok = false;
+            break;
+        }
+        downFds[i] = pair[0];
+        upFds[(i + 1) % workers] = pair[1];
+        if (io.collect) {
+            int result[2];
+            if (::pipe(result) != 0) {
+                std::cerr << "Error: Unable to create pipe: " << std::strerror(errno) << std::endl;
+                ok = false;
+                break;
+            }
+            resultReadFds[i] = result[0];
+            resultWriteFds[i] = result[1];
+        }
+    }
+
+    std::vector<pid_t> children;
+    for (int i = 0; i < workers && ok; ++i) {
+        pid_t pid = ::fork();
+        if (pid < 0) {
+            std::cerr << "Error: Unable to start worker process: " << std::strerror(errno) << std::endl;
+            ok = false;
+            break;
+        }
+        if (pid == 0) {
+            // Чужие концы каналов закрываются, иначе родитель не заметил бы завершения процесса с ошибкой
+            closeAll(downFds, i);
+            closeAll(upFds, i);
+            closeAll(resultReadFds, -1);
+            closeAll(resultWriteFds, i);
+            bool done = runWorker(cols, rule, generations, rowBegin(i), rowBegin(i + 1), upFds[i], downFds[i], io,
+                                  resultWriteFds[i]);
+            // _exit: дочерний процесс не должен сбрасывать буферы и вызывать деструкторы родителя
+            ::_exit(done ? 0 : 1);
+        }
+        children.push_back(pid);
+    }
+    closeAll(downFds, -1);
+    closeAll(upFds, -1);
+    closeAll(resultWriteFds, -1);
+
+    // Итоговые полосы принимаются по порядку: закончивший процесс ждет в записи, остальным он уже не нужен
+    auto killChildren = [&]() {
+        for (pid_t child : children) {
+            ::kill(child, SIGKILL);
+        }
+    };
+    bool failed = !ok;
+    if (ok && io.collect) {
+        for (int i = 0; i < workers && !failed; ++i) {
+            if (!io.collect(rowBegin(i), rowBegin(i + 1), resultReadFds[i])) {
+                std::cerr << "Error: Worker process failed" << std::endl;
+                failed = true;
+            }
+        }
+    }
+    closeAll(resultReadFds, -1);
+    if (failed) {
+        killChildren();
+    }
+
+    // Если один процесс завершился с ошибкой, остальные останавливаются: без его строк им не продолжить
+    std::size_t finished = 0;
+    while (finished < children.size()) {
+        int status = 0;
+        pid_t pid = ::waitpid(-1, &status, 0);
+        if (pid < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            failed = true;
+            break;
+        }
+        if (std::find(children.begin(), children.end(), pid) == children.end()) {
+            continue;
+        }
+        ++finished;
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            if (!failed) {
+                std::cerr << "Error: Worker process failed" << std::endl;
+                killChildren();
+            }
+            failed = true;
+        }
+    }
+    return !failed;
+}
+
+} // namespace
+
+bool runDistributed(Grid& grid, const RuleMasks& rule, long long generations, int workers) {
+    if (workers < 1 || workers > grid.rows()) {
+        std::cerr << "Error: Number of processes must be between 1 and the number of rows (" << grid.rows() << ")"
+                  << std::endl;
+        return false;
+    }
+    if (generations <= 0) {
+        return true;
+    }
+
+    // Процессы читают свою полосу из унаследованного поля (страницы общие, пока их никто не меняет),
+    // а итог родитель читает из канала прямо в строки поля
+    const std::size_t rowBytes = static_cast<std::size_t>(grid.wordsPerRow()) * sizeof(Grid::Word);
+    const Grid& source = grid;
+    StripeIo io;
+    io.load = [&](int rowBegin, int rowEnd, Grid::Word* words) {
+        std::memcpy(words, source.rowData(rowBegin), (rowEnd - rowBegin) * rowBytes);
+        return true;
+    };
+    io.store = [&](int rowBegin, int rowEnd, const Grid::Word* words, int resultFd) {
+        return writeExact(resultFd, reinterpret_cast<const char*>(words), (rowEnd - rowBegin) * rowBytes);
+    };
+    io.collect = [&](int rowBegin, int rowEnd, int resultFd) {
+        return readExact(resultFd, reinterpret_cast<char*>(grid.rowData(rowBegin)), (rowEnd - rowBegin) * rowBytes);
+    };
+    return runWorkers(grid.rows(), grid.cols(), rule, generations, workers, io);
+}
+
+bool runDistributed(const std::string& input, const std::string& output, long long generations, int workers) {
+    SnapshotHeader header;
+    if (!readSnapshotHeader(input, header)) {
+        return false;
+    }
+    const int rows = static_cast<int>(header.rows);
+    const int cols = static_cast<int>(header.cols);
+    if (workers < 1 || workers > rows) {
+        std::cerr << "Error: Number of processes must be between 1 and the number of rows (" << rows << ")"
+                  << std::endl;
+        return false;
+    }
+    generations = std::max(0LL, generations);
+
+    int inputFd = ::open(input.c_str(), O_RDONLY);
+    if (inputFd < 0) {
+        std::cerr << "Error: Unable to open input file '" << input << "'" << std::endl;
+        return false;
+    }
+    struct stat inputInfo, outputInfo;
+    if (::fstat(inputFd, &inputInfo) == 0 && ::stat(output.c_str(), &outputInfo) == 0 &&
+        inputInfo.st_dev == outputInfo.st_dev && inputInfo.st_ino == outputInfo.st_ino) {
+        std::cerr << "Error: Output file '" << output << "' must differ from the input file" << std::endl;
+        ::close(inputFd);
+        return false;
+    }
+
+    const std::size_t words = snapshotWordCount(header);
+    const std::size_t rowBytes = words / rows * sizeof(Grid::Word);
+    const off_t wordsOffset = static_cast<off_t>(sizeof(SnapshotHeader));
+    std::vector<Grid::Word> chunk(std::min<std::size_t>(words, kChunkWords));
+
+    // Контрольная сумма входа проверяется потоком по частям: поле целиком в памяти не собирается
+    auto checksumOf = [&](int fd, std::uint64_t& checksum) {
+        checksum = gridChecksumStart(words);
+        for (std::size_t done = 0; done < words;) {
+            std::size_t count = std::min(chunk.size(), words - done);
+            if (!readExact(fd, reinterpret_cast<char*>(chunk.data()), count * sizeof(Grid::Word),
+                           wordsOffset + static_cast<off_t>(done * sizeof(Grid::Word)))) {
+                return false;
+            }
+            checksum = gridChecksumUpdate(checksum, chunk.data(), count);
+            done += count;
+        }
+        return true;
+    };
+    if (header.flags & kHasChecksum) {
+        std::uint64_t expected = 0, actual = 0;
+        if (!readExact(inputFd, reinterpret_cast<char*>(&expected), sizeof(expected),
+                       wordsOffset + static_cast<off_t>(words * sizeof(Grid::Word))) ||
+            !checksumOf(inputFd, actual) || actual != expected) {
+            std::cerr << "Error: Invalid snapshot '" << input << "': checksum mismatch" << std::endl;
+            ::close(inputFd);
+            return false;
+        }
+    }
+
+    // Выходной снимок создается разреженным на полный размер, процессы пишут в него свои полосы
+    int outputFd = ::open(output.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    SnapshotHeader result = header;
+    result.flags = 0;
+    result.generation = header.generation + static_cast<std::uint64_t>(generations);
+    bool ok = outputFd >= 0 &&
+              ::ftruncate(outputFd, wordsOffset + static_cast<off_t>(words * sizeof(Grid::Word))) == 0 &&
+              writeExact(outputFd, reinterpret_cast<const char*>(&result), sizeof(result), 0);
+    if (!ok) {
+        std::cerr << "Error: Unable to open output file '" << output << "'" << std::endl;
+    }
+
+    const Grid::Word tail = cols % Grid::kWordBits == 0 ? ~Grid::Word(0)
+                                                        : (Grid::Word(1) << (cols % Grid::kWordBits)) - 1;
+    StripeIo io;
+    io.load = [&](int rowBegin, int rowEnd, Grid::Word* stripe) {
+        // Неиспользуемые биты в конце строк должны оставаться нулевыми
+        if (!readExact(inputFd, reinterpret_cast<char*>(stripe), (rowEnd - rowBegin) * rowBytes,
+                       wordsOffset + static_cast<off_t>(rowBegin * rowBytes))) {
+            return false;
+        }
+        const std::size_t rowWords = rowBytes / sizeof(Grid::Word);
+        for (int row = 0; row < rowEnd - rowBegin; ++row) {
+            if (stripe[(row + 1) * rowWords - 1] & ~tail) {
+                std::cerr << "Error: Invalid snapshot '" << input << "': cells outside the field" << std::endl;
+                return false;
+            }
+        }
+        return true;
+    };
+    io.store = [&](int rowBegin, int rowEnd, const Grid::Word* stripe, int) {
+        return writeExact(outputFd, reinterpret_cast<const char*>(stripe), (rowEnd - rowBegin) * rowBytes,
+                          wordsOffset + static_cast<off_t>(rowBegin * rowBytes));
+    };
+    ok = ok && runWorkers(rows, cols, RuleMasks{header.birth, header.survival}, generations, workers, io);
+    ::close(inputFd);
+
+    // Контрольная сумма выхода считается тем же потоковым проходом и дописывается в конец
+    if (ok) {
+        std::uint64_t checksum = 0;
+        result.flags = kHasChecksum;
+        ok = checksumOf(outputFd, checksum) &&
+             writeExact(outputFd, reinterpret_cast<const char*>(&checksum), sizeof(checksum),
+                        wordsOffset + static_cast<off_t>(words * sizeof(Grid::Word))) &&
+             writeExact(outputFd, reinterpret_cast<const char*>(&result), sizeof(result), 0);
+        if (!ok) {
+            std::cerr << "Error: Unable to write output file '" << output << "'" << std::endl;
+        }
+    }
+    if (outputFd >= 0 && ::close(outputFd) != 0) {
+        ok = false;
+    }
+    if (!ok) {
+        ::unlink(output.c_str());
+    }
+    return ok;
+}
@@ -1,9 +1,12 @@
 #include "include/GameOfLife.h"
+#include "include/LifeFile.h"
+#include "include/Renderer.h"
+#include "include/PatternCache.h"
 #include <fstream>
 #include <iostream>
-#include <sstream>
 #include <random>
 #include <filesystem>
+#include <utility>
 
 // Функция для проверки, заканчивается ли строка на заданный суффикс
 bool endsWith(const std::string& str, const std::string& suffix) {
@@ -16,39 +19,22 @@ bool endsWith(const std::string& str, const std::string& suffix) {
 namespace fs = std::filesystem;
 
 void Game::loadTemplate(const std::string& filename, int startX, int startY) {
-    std::ifstream file("templates/" + filename);
-    if (!file.is_open()) {
+    // Шаблон берется из кэша уже упакованным и накладывается словами с замыканием краев
+    const Grid* pattern = patternCache().findTemplate(filename);
+    if (pattern == nullptr) {
         throw std::runtime_error("Template file not found: " + filename);
     }
-
-    std::string line;
-    int y = startY;
-    while (std::getline(file, line)) {
-        for (size_t x = 0; x < line.size(); ++x) {
-            if (line[x] == 'O') {
-                field[y][x + startX].isAlive = true;
-            }
-        }
-        ++y;
-    }
-    file.close();
+    blitPattern(field, *pattern, startY, startX);
 }
 
 void Game::generateRandomState() {
-    const std::string templatesDir = "templates";
-    std::vector<std::string> templates;
-
-    if (fs::exists(templatesDir) && fs::is_directory(templatesDir)) {
-        for (const auto& entry : fs::directory_iterator(templatesDir)) {
-            if (entry.is_regular_file() && entry.path().extension() == ".txt") {
-                templates.push_back(entry.path().filename().string());
-            }
-        }
-    } else {
+    PatternCache& cache = patternCache();
+    if (!cache.templatesFound()) {
         std::cerr << "Templates directory not found!" << std::endl;
         return;
     }
 
+    const std::vector<std::string>& templates = cache.templateNames();
     if (templates.empty()) {
         std::cerr << "No templates found in the templates directory!" << std::endl;
         return;
@@ -78,6 +64,22 @@ bool Game::isInteger(const std::string& str) {
 }
 
 void Game::parseRules(const std::string& ruleString) {
+    // Правило Larger than Life: диапазоны B и S разворачиваются в списки чисел соседей для эталонного расчета
+    RangeRule range;
+    if (parseRangeRule(ruleString, range)) {
+        rangeRule = range;
+        birthRules.clear();
+        survivalRules.clear();
+        for (int count = range.birthMin; count <= range.birthMax; ++count) {
+            birthRules.push_back(count);
+        }
+        for (int count = range.surviveMin; count <= range.surviveMax; ++count) {
+            survivalRules.push_back(count);
+        }
+        ruleMasks = RuleMasks();
+        return;
+    }
+
     std::string birth, survival;
     std::string delimiter = "/";
     size_t pos = ruleString.find(delimiter);
@@ -110,104 +112,524 @@ void Game::parseRules(const std::string& ruleString) {
                 }
             }
         }
+
+        // Компилируем правила в маски для ядер расчета
+        rangeRule = RangeRule();
+        ruleMasks = RuleMasks();
+        for (int rule : birthRules) {
+            ruleMasks.birth |= 1u << rule;
+        }
+        for (int rule : survivalRules) {
+            ruleMasks.survival |= 1u << rule;
+        }
     }
 }
 
+std::string Game::ruleString() const {
+    if (rangeRule.active()) {
+        return formatRangeRule(rangeRule);
+    }
+    std::string text = "B";
+    for (int i : birthRules) {
+        text += static_cast<char>('0' + i);
+    }
+    text += "/S";
+    for (int i : survivalRules) {
+        text += static_cast<char>('0' + i);
+    }
+    return text;
+}
 
 
 
-void Game::readFromFile(const std::string& filename) {
-    std::ifstream inputFile(filename);
-    if (!inputFile.is_open()) {
-        std::cerr << "Error: Unable to open input file '" << filename << "'" << std::endl;
-        return;
+bool Game::readFromFile(const std::string& filename) {
+    GOL_SCOPED_TIMER(Phase::Load);
+    if (endsWith(filename, ".snap")) {
+        RuleMasks rule;
+        std::uint64_t generation = 0;
+        if (!readSnapshot(filename, field, rule, generation)) {
+            return false;
+        }
+        numRows = field.rows();
+        numCols = field.cols();
+        nextField.resize(numRows, numCols);
+        activity.reset(numRows, numCols);
+        parseRules(formatRule(rule));
+        curIteration = static_cast<long long>(generation);
+        if (verbose) {
+            std::cout << "Game state loaded from snapshot '" << filename << "' (" << numRows << "x" << numCols
+                      << ", generation " << curIteration << ")" << std::endl;
+        }
+        return true;
     }
 
-    std::string line;
-    while (std::getline(inputFile, line)) {
-        if (line.empty() || line[0] == '#') {
-            continue;
+    // Клетки за пределами поля не помещаются на тор этого размера — сообщаем, сколько их пропущено
+    std::size_t skipped = 0;
+    auto placeCell = [&](std::int64_t x, std::int64_t y) {
+        if (x >= 0 && x < numCols && y >= 0 && y < numRows) {
+            field.set(static_cast<int>(y), static_cast<int>(x), true);
+        } else {
+            ++skipped;
+        }
+    };
+
+    bool opened;
+    if (endsWith(filename, ".rle")) {
+        std::string ruleText;
+        opened = readRle(filename, placeCell, ruleText);
+        RuleMasks rule;
+        RangeRule range;
+        if (!ruleText.empty() && parseRuleMasks(ruleText, rule)) {
+            parseRules(formatRule(rule));
+        } else if (parseRangeRule(ruleText, range)) {
+            parseRules(ruleText);
+        } else if (!ruleText.empty()) {
+            std::cerr << "Warning: unsupported rule '" << ruleText << "' in '" << filename << "' was ignored"
+                      << std::endl;
         }
+    } else {
+        opened = readLife106(filename, placeCell);
+    }
+    if (!opened) {
+        return false;
+    }
 
-        std::istringstream iss(line);
-        int x, y;
-        if (iss >> x >> y) {
-            if (x >= 0 && x < numCols && y >= 0 && y < numRows) {
-                field[y][x].isAlive = true;
-            }
+    if (skipped > 0) {
+        std::cerr << "Warning: " << skipped << " cells outside the " << numRows << "x" << numCols
+                  << " field were skipped (use --engine=infinite to keep them)" << std::endl;
+    }
+    if (verbose) {
+        std::cout << "Game state loaded from file '" << filename << "'" << std::endl;
+    }
+    return true;
+}
+
+bool Game::saveToFile(const std::string& filename) {
+    return saveToFile(filename, field, curIteration);
+}
+
+bool Game::saveToFile(const std::string& filename, const Grid& grid, long long iteration) {
+    GOL_SCOPED_TIMER(Phase::Save);
+    bool saved;
+    if (endsWith(filename, ".snap")) {
+        // В заголовке снимка правило хранится масками B/S: правило Larger than Life в нем не записать
+        if (rangeRule.active()) {
+            std::cerr << "Error: snapshots keep only B/S rules, save rule " << ruleString()
+                      << " to a .rle or .lif file instead" << std::endl;
+            return false;
+        }
+        saved = writeSnapshot(filename, grid, ruleMasks, static_cast<std::uint64_t>(iteration));
+    } else if (endsWith(filename, ".rle")) {
+        saved = writeRle(filename, grid, gameName, ruleString());
+    } else {
+        FileWriter outputFile(filename);
+        if (!outputFile.isOpen()) {
+            std::cerr << "Error: Unable to open output file '" << filename << "'" << std::endl;
+            return false;
+        }
+
+        outputFile.write("#Life 1.06\n#N ");
+        outputFile.write(gameName);
+        outputFile.write("\n#R ");
+        outputFile.write(ruleString());
+        outputFile.write("\n#S ");
+        outputFile.writeInt(grid.rows());
+        outputFile.put(' ');
+        outputFile.writeInt(grid.cols());
+        outputFile.put('\n');
+
+        writeLife106Cells(outputFile, grid);
+        saved = outputFile.close();
+        if (!saved) {
+            std::cerr << "Error: Unable to write output file '" << filename << "'" << std::endl;
         }
     }
 
-    inputFile.close();
-    std::cout << "Game state loaded from file '" << filename << "'" << std::endl;
+    if (saved && verbose) {
+        std::cout << "Game state saved to file '" << filename << "'" << std::endl;
+    }
+    return saved;
+}
+
+void Game::resize(int rows, int cols) {
+    numRows = rows;
+    numCols = cols;
+    field.resize(rows, cols);
+    nextField.resize(rows, cols);
+    activity.reset(rows, cols);
+}
+
+void Game::setThreads(int threads) {
+    threadPool = threads > 1 ? std::make_shared<ThreadPool>(threads) : nullptr;
+}
+
+// Рассчитать строки [rowBegin, rowEnd) следующего поколения в буфер next
+static void stepRows(RowKernel kernel, const Grid& current, Grid::Word* next, int rowBegin, int rowEnd,
+                     const RuleMasks& rule) {
+    const int numRows = current.rows();
+    const int words = current.wordsPerRow();
+
+    for (int row = rowBegin; row < rowEnd; ++row) {
+        // Соседние строки с замыканием по вертикали вычисляются один раз на строку
+        int upRow = row == 0 ? numRows - 1 : row - 1;
+        int downRow = row == numRows - 1 ? 0 : row + 1;
+        kernel(current.rowData(upRow), current.rowData(row), current.rowData(downRow),
+               next + static_cast<std::size_t>(row) * words, current.cols(), 0, words, rule);
+    }
+}
+
+// Продвинуть полосу строк [rowBegin, rowEnd) сразу на steps поколений и записать результат в next.
+// Полоса берется с запасом в steps строк с каждой стороны (трапеция): на каждом шаге верная часть
+// сужается на строку с каждой стороны, и после steps шагов верна ровно сама полоса. Первый шаг
+// читает поле, последний пишет в next, промежуточные поколения живут в двух буферах scratch
+// по rowEnd - rowBegin + 2 * steps строк, которые помещаются в кэш.
+static void stepBand(RowKernel kernel, const Grid& current, Grid::Word* next, int rowBegin, int rowEnd, int steps,
+                     Grid::Word* scratch, const RuleMasks& rule) {
+    const int numRows = current.rows();
+    const int words = current.wordsPerRow();
+    const int height = rowEnd - rowBegin + 2 * steps;
+    Grid::Word* buffers[2] = {scratch, scratch + static_cast<std::size_t>(height) * words};
+
+    // Строка буфера local соответствует строке поля rowBegin - steps + local (с замыканием по вертикали)
+    auto sourceRow = [&](int step, int local) -> const Grid::Word* {
+        if (step == 1) {
+            int row = ((rowBegin - steps + local) % numRows + numRows) % numRows;
+            return current.rowData(row);
+        }
+        return buffers[(step - 1) % 2] + static_cast<std::size_t>(local) * words;
+    };
+
+    for (int step = 1; step <= steps; ++step) {
+        for (int local = step; local < height - step; ++local) {
+            Grid::Word* out = step == steps ? next + static_cast<std::size_t>(rowBegin - steps + local) * words
+                                            : buffers[step % 2] + static_cast<std::size_t>(local) * words;
+            kernel(sourceRow(step, local - 1), sourceRow(step, local), sourceRow(step, local + 1), out,
+                   current.cols(), 0, words, rule);
+        }
+    }
+}
+
+// Учесть изменение слова номер index в сводке поля
+static inline void addWordDelta(Grid::Word before, Grid::Word after, std::size_t index, StepDelta& delta) {
+    delta.hash ^= gridWordHash(before, index) ^ gridWordHash(after, index);
+    delta.births += __builtin_popcountll(after & ~before);
+    delta.deaths += __builtin_popcountll(before & ~after);
+}
+
+// Изменение сводки между двумя поколениями целиком (проход по всем словам)
+static void addGridDelta(const Grid& before, const Grid& after, StepDelta& delta) {
+    const Grid::Word* was = before.data();
+    const Grid::Word* now = after.data();
+    for (std::size_t i = 0; i < before.wordCount(); ++i) {
+        if (was[i] != now[i]) {
+            addWordDelta(was[i], now[i], i, delta);
+        }
+    }
+}
+
+// Рассчитать активные плитки ряда tileRow и отметить те, что изменились.
+// В неактивных плитках next уже содержит нужное состояние: там лежит прошлое поколение,
+// которое совпадает с текущим. Если задан summary, туда пишется изменение сводки поля по этому ряду.
+static void stepTileRow(RowKernel kernel, const Grid& current, Grid::Word* next, ActivityTracker& activity,
+                        int tileRow, const RuleMasks& rule, StepDelta* summary) {
+    const auto* runsBegin = activity.runsBegin(tileRow);
+    const auto* runsEnd = activity.runsEnd(tileRow);
+    if (runsBegin == runsEnd) {
+        return;
+    }
+
+    const int numRows = current.rows();
+    const int words = current.wordsPerRow();
+    const int rowBegin = tileRow * ActivityTracker::kTileRows;
+    const int rowEnd = std::min(rowBegin + ActivityTracker::kTileRows, numRows);
+    StepDelta delta;
+
+    for (int row = rowBegin; row < rowEnd; ++row) {
+        int upRow = row == 0 ? numRows - 1 : row - 1;
+        int downRow = row == numRows - 1 ? 0 : row + 1;
+        const Grid::Word* mid = current.rowData(row);
+        Grid::Word* out = next + static_cast<std::size_t>(row) * words;
+
+        for (const auto* run = runsBegin; run != runsEnd; ++run) {
+            kernel(current.rowData(upRow), mid, current.rowData(downRow), out, current.cols(),
+                   run->first, run->second, rule);
+            for (int word = run->first; word < run->second; ++word) {
+                if (out[word] != mid[word]) {
+                    activity.markChanged(tileRow, word);
+                    if (summary) {
+                        addWordDelta(mid[word], out[word], static_cast<std::size_t>(row) * words + word, delta);
+                    }
+                }
+            }
+        }
+    }
+    if (summary) {
+        *summary = delta;
+    }
 }
 
-void Game::saveToFile(const std::string& filename) {
-    std::ofstream outputFile(filename);
-    if (!outputFile.is_open()) {
-        std::cerr << "Error: Unable to open output file '" << filename << "'" << std::endl;
+void Game::calculateNextState() {
+#if GOL_METRICS
+    ScopedTimer timer(Phase::Step);
+#endif
+    // Правило Larger than Life считается своим ядром по всему полю, без активных плиток;
+    // сводка поля обновляется отдельным проходом по изменившимся словам
+    if (rangeRule.active()) {
+        const bool updateSummary = trackHash || collectStats;
+        StepDelta summary;
+        if (updateSummary) {
+            refreshSummary();
+        }
+        rangeKernel.step(field, nextField, rangeRule, threadPool.get());
+        if (updateSummary) {
+            addGridDelta(std::as_const(field), std::as_const(nextField), summary);
+        }
+        field.swap(nextField);
+        ++curIteration;
+        activity.invalidate();
+        activeTiles = activity.tileCount();
+        if (updateSummary) {
+            fieldHash ^= summary.hash;
+            births = summary.births;
+            deaths = summary.deaths;
+            population += births;
+            population -= deaths;
+            summaryVersion = field.version();
+        }
+#if GOL_METRICS
+        metrics().addCells(static_cast<std::uint64_t>(numRows) * numCols);
+        if (collectStats) {
+            metrics().recordGeneration({curIteration, population, births, deaths, timer.elapsedNanoseconds()});
+        }
+#endif
         return;
     }
 
-    outputFile << "#Life 1.06" << std::endl;
-    outputFile << "#N " << gameName << std::endl;
-    outputFile << "#R B";
+    // Специализированное под правило ядро, если оно есть, иначе общее по маскам
+    RowKernel rowKernel = kernel->select(ruleMasks);
 
-    for (int i : birthRules) {
-        outputFile << i;
+    // Буферы выделяются один раз; заново — только если размер поля изменился
+    if (nextField.rows() != numRows || nextField.cols() != numCols) {
+        nextField.resize(numRows, numCols);
     }
-    outputFile << "/S";
+    Grid::Word* next = nextField.data();
 
-    for (int i : survivalRules) {
-        outputFile << i;
+    // Сводка поля обновляется по изменившимся словам; если поле меняли снаружи, она сначала пересчитывается
+    const bool updateSummary = trackHash || collectStats;
+    StepDelta summary;
+    if (updateSummary) {
+        refreshSummary();
     }
-    outputFile << std::endl;
 
-    outputFile << "#S " << numRows << " " << numCols << std::endl;
+    if (trackActivity) {
+        // Если поле меняли снаружи или сменилось правило, история изменений недействительна
+        if (!activity.matches(numRows, numCols)) {
+            activity.reset(numRows, numCols);
+        } else if (field.version() != trackedVersion || ruleMasks != trackedRule) {
+            activity.invalidate();
+        }
+        activity.beginStep();
+
+        if (updateSummary) {
+            stepDeltas.assign(activity.tileRows(), StepDelta());
+        }
+        auto stepTiles = [&](int tileRow) {
+            stepTileRow(rowKernel, field, next, activity, tileRow, ruleMasks,
+                        updateSummary ? &stepDeltas[tileRow] : nullptr);
+        };
+        if (threadPool) {
+            threadPool->parallelFor(activity.tileRows(), stepTiles);
+        } else {
+            for (int tileRow = 0; tileRow < activity.tileRows(); ++tileRow) {
+                stepTiles(tileRow);
+            }
+        }
 
-    for (int i = 0; i < numRows; ++i) {
-        for (int j = 0; j < numCols; ++j) {
-            if (field[i][j].isAlive) {
-                outputFile << j << " " << i << std::endl;
+        activity.endStep();
+        activeTiles = activity.activeCount();
+        if (updateSummary) {
+            for (const StepDelta& delta : stepDeltas) {
+                summary.hash ^= delta.hash;
+                summary.births += delta.births;
+                summary.deaths += delta.deaths;
             }
         }
+    } else {
+        if (threadPool) {
+            // Каждый поток считает свою полосу строк; строки читаются только из текущего поколения,
+            // поэтому результат совпадает с однопоточным бит в бит
+            int stripes = std::min(threadPool->size(), numRows);
+            threadPool->parallelFor(stripes, [&](int stripe) {
+                stepRows(rowKernel, field, next, numRows * stripe / stripes, numRows * (stripe + 1) / stripes,
+                         ruleMasks);
+            });
+        } else {
+            stepRows(rowKernel, field, next, 0, numRows, ruleMasks);
+        }
+        activity.invalidate();
+        activeTiles = activity.tileCount();
+
+        // Без отслеживания плиток изменившиеся слова ищутся отдельным проходом
+        if (updateSummary) {
+            addGridDelta(std::as_const(field), std::as_const(nextField), summary);
+        }
     }
 
-    outputFile.close();
-    std::cout << "Game state saved to file '" << filename << "'" << std::endl;
+    // Новое поколение становится текущим, старое — буфером для следующего шага
+    field.swap(nextField);
+    ++curIteration;
+    if (updateSummary) {
+        fieldHash ^= summary.hash;
+        births = summary.births;
+        deaths = summary.deaths;
+        population += births;
+        population -= deaths;
+        summaryVersion = field.version();
+    }
+    trackedVersion = field.version();
+    trackedRule = ruleMasks;
+
+#if GOL_METRICS
+    metrics().addCells(static_cast<std::uint64_t>(numRows) * numCols);
+    if (collectStats) {
+        metrics().recordGeneration({curIteration, population, births, deaths, timer.elapsedNanoseconds()});
+    }
+#endif
 }
 
-void Game::calculateNextState() {
-    std::vector<std::vector<Cell>> nextState(numRows, std::vector<Cell>(numCols));
+void Game::advance(long long generations) {
+    // Блоки поколений считаются только для правил B/S: запаса в blockSteps строк хватает лишь для радиуса 1
+    if (blockSteps <= 1 || rangeRule.active()) {
+        for (long long i = 0; i < generations; ++i) {
+            calculateNextState();
+        }
+        return;
+    }
+    while (generations > 0) {
+        int steps = static_cast<int>(std::min<long long>(generations, blockSteps));
+        calculateNextStates(steps);
+        generations -= steps;
+    }
+}
+
+void Game::calculateNextStates(int steps) {
+#if GOL_METRICS
+    ScopedTimer timer(Phase::Step);
+#endif
+    RowKernel rowKernel = kernel->select(ruleMasks);
+    if (nextField.rows() != numRows || nextField.cols() != numCols) {
+        nextField.resize(numRows, numCols);
+    }
+    Grid::Word* next = nextField.data();
+
+    // Высота полосы подбирается так, чтобы оба промежуточных буфера полосы помещались в кэш;
+    // полоса не уже 2 * steps строк, иначе лишний расчет запаса перевесит выигрыш
+    const int words = field.wordsPerRow();
+    const std::size_t rowBytes = static_cast<std::size_t>(words) * sizeof(Grid::Word);
+    int bandRows = static_cast<int>(kBlockCacheBytes / (2 * rowBytes)) - 2 * steps;
+    bandRows = std::min(numRows, std::max(bandRows, 2 * steps));
+    const int bands = (numRows + bandRows - 1) / bandRows;
+    const int stripes = threadPool ? std::min(threadPool->size(), bands) : 1;
+    const std::size_t scratchWords = 2 * static_cast<std::size_t>(bandRows + 2 * steps) * words;
+    if (blockScratch.size() < scratchWords * stripes) {
+        blockScratch.resize(scratchWords * stripes);
+    }
+
+    // Полосы независимы: каждый поток проходит свою часть полос со своими буферами
+    auto stepStripe = [&](int stripe) {
+        Grid::Word* scratch = blockScratch.data() + scratchWords * stripe;
+        for (int band = bands * stripe / stripes; band < bands * (stripe + 1) / stripes; ++band) {
+            int rowBegin = band * bandRows;
+            stepBand(rowKernel, field, next, rowBegin, std::min(numRows, rowBegin + bandRows), steps, scratch,
+                     ruleMasks);
+        }
+    };
+    if (threadPool && stripes > 1) {
+        threadPool->parallelFor(stripes, stepStripe);
+    } else {
+        stepStripe(0);
+    }
+
+    // Промежуточные поколения не сохраняются: активность плиток и сводка поля считаются заново
+    field.swap(nextField);
+    curIteration += steps;
+    activity.invalidate();
+    activeTiles = activity.tileCount();
+#if GOL_METRICS
+    metrics().addCells(static_cast<std::uint64_t>(numRows) * numCols * steps);
+#endif
+}
+
+void Game::exchangePreviousGeneration(Grid& grid) {
+    nextField.swap(grid);
+    activity.invalidate();
+}
+
+void Game::refreshSummary() {
+    if (summaryVersion != field.version()) {
+        fieldHash = gridHash(field);
+        population = field.population();
+        births = 0;
+        deaths = 0;
+        summaryVersion = field.version();
+    }
+}
+
+std::uint64_t Game::stateHash() {
+    refreshSummary();
+    return fieldHash;
+}
+
+// Поклеточный расчет следующего поколения через countNeighbors (эталон для проверки)
+void Game::calculateNextStateReference() {
+    Grid nextState(numRows, numCols);
 
     for (int row = 0; row < numRows; ++row) {
         for (int col = 0; col < numCols; ++col) {
             int neighbors = countNeighbors(row, col);
 
-            if (field[row][col].isAlive) {
+            if (field.get(row, col)) {
                 // Если клетка жива, она должна выжить только если количество соседей соответствует survivalRules
-                nextState[row][col].isAlive = std::find(survivalRules.begin(), survivalRules.end(), neighbors) != survivalRules.end();
+                nextState.set(row, col, std::find(survivalRules.begin(), survivalRules.end(), neighbors) != survivalRules.end());
             } else {
                 // Если клетка мертва, она должна воскреснуть только если количество соседей соответствует birthRules
-                nextState[row][col].isAlive = std::find(birthRules.begin(), birthRules.end(), neighbors) != birthRules.end();
+                nextState.set(row, col, std::find(birthRules.begin(), birthRules.end(), neighbors) != birthRules.end());
             }
         }
     }
 
     // Переносим новое состояние в поле
     field = std::move(nextState);
+    ++curIteration;
 }
 
 
 
 int Game::countNeighbors(int row, int col) {
+    if (rangeRule.active()) {
+        // Окрестность радиуса R: квадрат Мура или ромб фон Неймана, центр — только при M1
+        const int range = rangeRule.range;
+        const bool moore = rangeRule.neighborhood == RangeRule::Neighborhood::Moore;
+        int count = 0;
+        for (int i = -range; i <= range; ++i) {
+            const int span = moore ? range : range - std::abs(i);
+            for (int j = -span; j <= span; ++j) {
+                if (i == 0 && j == 0 && !rangeRule.countCenter) continue;
+                int neighborRow = ((row + i) % numRows + numRows) % numRows;
+                int neighborCol = ((col + j) % numCols + numCols) % numCols;
+                count += field.get(neighborRow, neighborCol);
+            }
+        }
+        return count;
+    }
+
     int count = 0;
     for (int i = -1; i <= 1; ++i) {
         for (int j = -1; j <= 1; ++j) {
             if (i == 0 && j == 0) continue;
             int neighborRow = (row + i + numRows) % numRows;
             int neighborCol = (col + j + numCols) % numCols;
-            if (field[neighborRow][neighborCol].isAlive) {
+            if (field.get(neighborRow, neighborCol)) {
                 ++count;
             }
         }
@@ -216,69 +638,35 @@ int Game::countNeighbors(int row, int col) {
 }
 
 void Game::printState() {
-    system("clear");
-    std::cout << "#Life v1.0" << std::endl;
-    std::cout << "#N " << gameName << std::endl;
-    std::cout << "#R B";
-
-    for (int i : birthRules) {
-        std::cout << i;
-    }
-    std::cout << "/S";
-
-    for (int i : survivalRules) {
-        std::cout << i;
-    }
-    std::cout << std::endl;
-
-    std::cout << curIteration << std::endl;
-    std::cout << "┌" << std::string(field[0].size(), '-') << "┐" << std::endl;
-
-    for (const auto& row : field) {
-        std::cout << "│";
-        for (const auto& cell : row) {
-            std::cout << (cell.isAlive ? 'X' : ' ');
-        }
-        std::cout << "│" << std::endl;
-    }
-
-    std::cout << "└" << std::string(field[0].size(), '-') << "┘" << std::endl;
+    // Полный кадр собирается в одном буфере и выводится одной записью, экран очищается ANSI-последовательностью
+    TerminalRenderer renderer;
+    renderer.draw(*this, std::cout);
 }
 
 
 void Game::loadRulesFromFile(const std::string& filename) {
-    std::ifstream file("rules/" + filename);
-    if (!file.is_open()) {
+    std::string ruleLine;
+    if (!patternCache().findRule(filename, ruleLine)) {
         std::cerr << "Error: Unable to open rules file '" << filename << "'" << std::endl;
         return;
     }
 
-    std::string ruleLine;
-    if (std::getline(file, ruleLine)) {
+    if (!ruleLine.empty()) {
         parseRules(ruleLine);
         std::cout << "Loaded rules: " << ruleLine << std::endl;
     } else {
         std::cerr << "Error: Empty rules file!" << std::endl;
     }
-
-    file.close();
 }
 
 void Game::generateRandomRules() {
-    const std::string rulesDir = "rules";
-    std::vector<std::string> ruleFiles;
-
-    if (fs::exists(rulesDir) && fs::is_directory(rulesDir)) {
-        for (const auto& entry : fs::directory_iterator(rulesDir)) {
-            if (entry.is_regular_file() && entry.path().extension() == ".txt") {
-                ruleFiles.push_back(entry.path().filename().string());
-            }
-        }
-    } else {
+    PatternCache& cache = patternCache();
+    if (!cache.rulesFound()) {
         std::cerr << "Rules directory not found!" << std::endl;
         return;
     }
 
+    const std::vector<PatternCache::RuleEntry>& ruleFiles = cache.rules();
     if (ruleFiles.empty()) {
         std::cerr << "No rules files found in the rules directory!" << std::endl;
         return;
@@ -288,7 +676,7 @@ void Game::generateRandomRules() {
     std::mt19937 gen(rd());
     std::uniform_int_distribution<> dis(0, ruleFiles.size() - 1);
 
-    std::string selectedRuleFile = ruleFiles[dis(gen)];
+    std::string selectedRuleFile = ruleFiles[dis(gen)].file;
     loadRulesFromFile(selectedRuleFile);
     std::cout << "Loaded random rule: " << selectedRuleFile << std::endl;
 }
@@ -0,0 +1,33 @@
+#include "include/Grid.h"
+#include <algorithm>
+#include <bitset>
+
+void Grid::resize(int rows, int cols) {
+    numRows = rows;
+    numCols = cols;
+    rowWords = (cols + kWordBits - 1) / kWordBits;
+    ++modifications;
+    words.assign(static_cast<std::size_t>(numRows) * rowWords, 0);
+}
+
+void Grid::clear() {
+    ++modifications;
+    std::fill(words.begin(), words.end(), 0);
+}
+
+Grid::Word Grid::tailMask() const {
+    int used = numCols % kWordBits;
+    return used == 0 ? ~Word(0) : (Word(1) << used) - 1;
+}
+
+std::size_t Grid::population() const {
+    std::size_t count = 0;
+    for (Word word : words) {
+        count += std::bitset<kWordBits>(word).count();
+    }
+    return count;
+}
+
+bool Grid::operator==(const Grid& other) const {
+    return numRows == other.numRows && numCols == other.numCols && words == other.words;
+}
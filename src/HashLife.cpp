@@ -0,0 +1,425 @@
+#include "include/HashLife.h"
+#include "include/LifeFile.h"
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+std::uint64_t hashChildren(HashLife::NodeId nw, HashLife::NodeId ne, HashLife::NodeId sw, HashLife::NodeId se) {
+    std::uint64_t h = (static_cast<std::uint64_t>(nw) << 32 | ne) * 0x9E3779B97F4A7C15ull;
+    h ^= (static_cast<std::uint64_t>(sw) << 32 | se) * 0xC2B2AE3D27D4EB4Full;
+    h ^= h >> 29;
+    h *= 0xBF58476D1CE4E5B9ull;
+    return h ^ (h >> 32);
+}
+
+std::uint64_t saturatingAdd(std::uint64_t a, std::uint64_t b) {
+    return a > std::numeric_limits<std::uint64_t>::max() - b ? std::numeric_limits<std::uint64_t>::max() : a + b;
+}
+
+// Даже после сборки мусора внутри шага живых узлов слишком много — шаг нужно дробить
+struct StepExceedsMemory {};
+
+} // namespace
+
+HashLife::HashLife(const RuleMasks& rule, std::size_t memoryBudget) : rule(rule) {
+    // Рождение при нуле соседей заполнило бы всю бесконечную плоскость
+    if (rule.birth & 1u) {
+        throw std::runtime_error("Hashlife does not support rules with B0");
+    }
+
+    // На узел приходится сам узел и в среднем две ячейки хеш-таблицы (заполнение не выше половины)
+    nodeLimit = memoryBudget / (sizeof(Node) + 2 * sizeof(NodeId));
+    if (nodeLimit < 1024) {
+        nodeLimit = 1024;
+    }
+
+    nodes.push_back({0, kNoNode, kNoNode, kNoNode, kNoNode, kNoNode, 0, 0}); // Мертвая клетка
+    nodes.push_back({1, kNoNode, kNoNode, kNoNode, kNoNode, kNoNode, 0, 0}); // Живая клетка
+    rehash(1024);
+    root = emptyNode(3);
+}
+
+void HashLife::rehash(std::size_t slotCount) {
+    table.assign(slotCount, kNoNode);
+    const std::size_t mask = slotCount - 1;
+    for (NodeId id = 2; id < nodes.size(); ++id) {
+        const Node& n = nodes[id];
+        std::size_t slot = hashChildren(n.nw, n.ne, n.sw, n.se) & mask;
+        while (table[slot] != kNoNode) {
+            slot = (slot + 1) & mask;
+        }
+        table[slot] = id;
+    }
+}
+
+HashLife::NodeId HashLife::join(NodeId nw, NodeId ne, NodeId sw, NodeId se) {
+    const std::size_t mask = table.size() - 1;
+    std::size_t slot = hashChildren(nw, ne, sw, se) & mask;
+    for (NodeId id = table[slot]; id != kNoNode; id = table[slot]) {
+        const Node& n = nodes[id];
+        if (n.nw == nw && n.ne == ne && n.sw == sw && n.se == se) {
+            return id;
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    if (nodes.size() >= kNoNode - 1) {
+        throw std::runtime_error("Hashlife node index overflow");
+    }
+
+    std::uint64_t population = saturatingAdd(saturatingAdd(nodes[nw].population, nodes[ne].population),
+                                             saturatingAdd(nodes[sw].population, nodes[se].population));
+    NodeId id = static_cast<NodeId>(nodes.size());
+    nodes.push_back({population, nw, ne, sw, se, kNoNode, static_cast<std::uint8_t>(nodes[nw].level + 1), 0});
+    table[slot] = id;
+
+    // Держим заполнение таблицы не выше половины
+    if (nodes.size() * 2 > table.size()) {
+        rehash(table.size() * 2);
+    }
+    return id;
+}
+
+HashLife::NodeId HashLife::emptyNode(int level) {
+    if (level == 0) {
+        return kDeadCell;
+    }
+    if (static_cast<int>(emptyNodes.size()) <= level) {
+        emptyNodes.resize(level + 1, kNoNode);
+    }
+    if (emptyNodes[level] == kNoNode) {
+        NodeId child = emptyNode(level - 1);
+        emptyNodes[level] = join(child, child, child, child);
+    }
+    return emptyNodes[level];
+}
+
+HashLife::NodeId HashLife::expand(NodeId id) {
+    Node n = nodes[id];
+    NodeId e = emptyNode(n.level - 1);
+    return join(join(e, e, e, n.nw), join(e, e, n.ne, e), join(e, n.sw, e, e), join(n.se, e, e, e));
+}
+
+HashLife::NodeId HashLife::centerNode(NodeId id) {
+    Node n = nodes[id];
+    return join(nodes[n.nw].se, nodes[n.ne].sw, nodes[n.sw].ne, nodes[n.se].nw);
+}
+
+HashLife::NodeId HashLife::horizontalCenter(NodeId west, NodeId east) {
+    Node w = nodes[west];
+    Node e = nodes[east];
+    return join(w.ne, e.nw, w.se, e.sw);
+}
+
+HashLife::NodeId HashLife::verticalCenter(NodeId north, NodeId south) {
+    Node n = nodes[north];
+    Node s = nodes[south];
+    return join(n.sw, n.se, s.nw, s.ne);
+}
+
+// Узел уровня 2 (4x4): центральные 2x2 клетки через одно поколение
+HashLife::NodeId HashLife::baseSuccessor(NodeId id) {
+    int cells[4][4];
+    Node n = nodes[id];
+    const NodeId quadrants[4] = {n.nw, n.ne, n.sw, n.se};
+    for (int q = 0; q < 4; ++q) {
+        Node quadrant = nodes[quadrants[q]];
+        int row = (q / 2) * 2;
+        int col = (q % 2) * 2;
+        cells[row][col] = static_cast<int>(quadrant.nw);
+        cells[row][col + 1] = static_cast<int>(quadrant.ne);
+        cells[row + 1][col] = static_cast<int>(quadrant.sw);
+        cells[row + 1][col + 1] = static_cast<int>(quadrant.se);
+    }
+
+    NodeId next[2][2];
+    for (int row = 1; row <= 2; ++row) {
+        for (int col = 1; col <= 2; ++col) {
+            int neighbors = 0;
+            for (int i = -1; i <= 1; ++i) {
+                for (int j = -1; j <= 1; ++j) {
+                    if (i != 0 || j != 0) {
+                        neighbors += cells[row + i][col + j];
+                    }
+                }
+            }
+            std::uint16_t masks = cells[row][col] ? rule.survival : rule.birth;
+            next[row - 1][col - 1] = (masks >> neighbors) & 1u ? kLiveCell : kDeadCell;
+        }
+    }
+    return join(next[0][0], next[0][1], next[1][0], next[1][1]);
+}
+
+// Центральный квадрат узла (уровень на единицу меньше) через 2^step поколений, step <= level - 2.
+// Узлы, которые вызов держит между вложенными вызовами, лежат в его кадре стека pinned: сборка мусора
+// внутри шага сохраняет их и переписывает их номера, поэтому после вложенных вызовов они читаются из кадра
+HashLife::NodeId HashLife::successor(NodeId id, int step) {
+    const Node& n = nodes[id];
+    if (n.result != kNoNode && n.resultStep == step) {
+        return n.result;
+    }
+
+    NodeId result;
+    if (n.population == 0) {
+        result = emptyNode(n.level - 1);
+    } else if (n.level == 2) {
+        result = baseSuccessor(id);
+    } else {
+        const std::size_t frame = pinned.size();
+        pinned.push_back(id);
+        if (nodes.size() >= nodeLimit) {
+            collectGarbage();
+            if (nodes.size() > nodeLimit / 4 * 3) {
+                throw StepExceedsMemory();
+            }
+            id = pinned[frame];
+        }
+        const Node node = nodes[id];
+
+        // Девять перекрывающихся подквадратов уровня level - 1: pinned[frame + 1 .. frame + 9]
+        pinned.insert(pinned.end(), {
+            node.nw, horizontalCenter(node.nw, node.ne), node.ne,
+            verticalCenter(node.nw, node.sw), centerNode(id), verticalCenter(node.ne, node.se),
+            node.sw, horizontalCenter(node.sw, node.se), node.se,
+        });
+
+        // На полной скорости обе стадии продвигают на 2^(step-1) поколений,
+        // иначе первая стадия только берет центры, а все 2^step поколений делает вторая.
+        // Результаты первой стадии: pinned[frame + 10 .. frame + 18]
+        const bool fullSpeed = step == node.level - 2;
+        for (std::size_t i = 1; i <= 9; ++i) {
+            NodeId sub = pinned[frame + i];
+            NodeId c = fullSpeed ? successor(sub, step - 1) : centerNode(sub);
+            pinned.push_back(c);
+        }
+        const int nextStep = fullSpeed ? step - 1 : step;
+
+        // Четверти результата: pinned[frame + 19 .. frame + 22]
+        static const int corners[4] = {0, 1, 3, 4};
+        for (int corner : corners) {
+            const NodeId* c = pinned.data() + frame + 10 + corner;
+            NodeId quadrant = successor(join(c[0], c[1], c[3], c[4]), nextStep);
+            pinned.push_back(quadrant);
+        }
+        const NodeId* q = pinned.data() + frame + 19;
+        result = join(q[0], q[1], q[2], q[3]);
+        id = pinned[frame];
+        pinned.resize(frame);
+    }
+
+    nodes[id].result = result;
+    nodes[id].resultStep = static_cast<std::uint8_t>(step);
+    return result;
+}
+
+// Поле целиком лежит в центральной половине узла (внешнее кольцо четвертей пусто)
+bool HashLife::isCentered(NodeId id) const {
+    const Node& n = nodes[id];
+    std::uint64_t inner = saturatingAdd(saturatingAdd(nodes[nodes[n.nw].se].population, nodes[nodes[n.ne].sw].population),
+                                        saturatingAdd(nodes[nodes[n.sw].ne].population, nodes[nodes[n.se].nw].population));
+    return inner == n.population;
+}
+
+void HashLife::growToContain(std::int64_t x, std::int64_t y) {
+    while (true) {
+        int level = nodes[root].level;
+        std::int64_t half = std::int64_t(1) << (level - 1);
+        if (x >= -half && x < half && y >= -half && y < half) {
+            return;
+        }
+        if (level >= kMaxLevel) {
+            throw std::out_of_range("Hashlife coordinate is too large");
+        }
+        root = expand(root);
+    }
+}
+
+HashLife::NodeId HashLife::setCellIn(NodeId id, std::int64_t x, std::int64_t y, bool alive) {
+    Node n = nodes[id];
+    if (n.level == 0) {
+        return alive ? kLiveCell : kDeadCell;
+    }
+    std::int64_t half = std::int64_t(1) << (n.level - 1);
+    if (y < half) {
+        if (x < half) {
+            return join(setCellIn(n.nw, x, y, alive), n.ne, n.sw, n.se);
+        }
+        return join(n.nw, setCellIn(n.ne, x - half, y, alive), n.sw, n.se);
+    }
+    if (x < half) {
+        return join(n.nw, n.ne, setCellIn(n.sw, x, y - half, alive), n.se);
+    }
+    return join(n.nw, n.ne, n.sw, setCellIn(n.se, x - half, y - half, alive));
+}
+
+void HashLife::setCell(std::int64_t x, std::int64_t y, bool alive) {
+    growToContain(x, y);
+    std::int64_t half = std::int64_t(1) << (nodes[root].level - 1);
+    root = setCellIn(root, x + half, y + half, alive);
+}
+
+bool HashLife::getCell(std::int64_t x, std::int64_t y) const {
+    NodeId id = root;
+    std::int64_t half = std::int64_t(1) << (nodes[id].level - 1);
+    if (x < -half || x >= half || y < -half || y >= half) {
+        return false;
+    }
+    x += half;
+    y += half;
+    while (nodes[id].level > 0) {
+        const Node& n = nodes[id];
+        half = std::int64_t(1) << (n.level - 1);
+        if (y < half) {
+            id = x < half ? n.nw : n.ne;
+        } else {
+            id = x < half ? n.sw : n.se;
+            y -= half;
+        }
+        if (x >= half) {
+            x -= half;
+        }
+    }
+    return id == kLiveCell;
+}
+
+void HashLife::loadFromGrid(const Grid& grid) {
+    for (int row = 0; row < grid.rows(); ++row) {
+        for (int col = 0; col < grid.cols(); ++col) {
+            if (grid.get(row, col)) {
+                setCell(col, row, true);
+            }
+        }
+    }
+}
+
+void HashLife::copyToGrid(Grid& grid) const {
+    grid.clear();
+    forEachCell([&](std::int64_t x, std::int64_t y) {
+        if (x >= 0 && x < grid.cols() && y >= 0 && y < grid.rows()) {
+            grid.set(static_cast<int>(y), static_cast<int>(x), true);
+        }
+    });
+}
+
+void HashLife::advancePowerOfTwo(int log2Generations) {
+    if (log2Generations < 0 || log2Generations > kMaxLevel - 3) {
+        throw std::out_of_range("Hashlife step is too large");
+    }
+
+    // Поле должно лежать в центральной половине узла уровня не ниже step + 2;
+    // еще одно расширение гарантирует, что за 2^step поколений оно не выйдет за центр
+    while (nodes[root].level < log2Generations + 2 || !isCentered(root)) {
+        root = expand(root);
+    }
+    root = expand(root);
+    if (nodes[root].level > kMaxLevel) {
+        throw std::out_of_range("Hashlife pattern grew beyond the supported coordinate range");
+    }
+
+    // Сборка мусора идет и внутри шага (см. successor); если живых узлов шага все равно слишком много,
+    // недосчитанный шаг бросается, а поле продвигается двумя шагами вдвое короче
+    try {
+        root = successor(root, log2Generations);
+    } catch (const StepExceedsMemory&) {
+        pinned.clear();
+        collectGarbage();
+        if (log2Generations == 0) {
+            throw std::runtime_error("Hashlife memory budget is too small for this pattern");
+        }
+        advancePowerOfTwo(log2Generations - 1);
+        advancePowerOfTwo(log2Generations - 1);
+        return;
+    }
+    generationCount += std::uint64_t(1) << log2Generations;
+
+    if (nodes.size() > nodeLimit / 4 * 3) {
+        collectGarbage();
+    }
+}
+
+void HashLife::advance(std::uint64_t generations) {
+    for (int bit = 63; bit >= 0; --bit) {
+        if ((generations >> bit) & 1u) {
+            advancePowerOfTwo(bit);
+        }
+    }
+}
+
+HashLife::NodeId HashLife::copyReachable(NodeId id, std::vector<Node>& target, std::vector<NodeId>& remap) const {
+    if (remap[id] != kNoNode) {
+        return remap[id];
+    }
+    Node n = nodes[id];
+    n.nw = copyReachable(n.nw, target, remap);
+    n.ne = copyReachable(n.ne, target, remap);
+    n.sw = copyReachable(n.sw, target, remap);
+    n.se = copyReachable(n.se, target, remap);
+    n.result = kNoNode;
+    remap[id] = static_cast<NodeId>(target.size());
+    target.push_back(n);
+    return remap[id];
+}
+
+void HashLife::collectGarbage() {
+    peakNodes = std::max(peakNodes, nodes.size());
+    std::vector<NodeId> remap(nodes.size(), kNoNode);
+    remap[kDeadCell] = kDeadCell;
+    remap[kLiveCell] = kLiveCell;
+
+    std::vector<Node> live;
+    live.push_back(nodes[kDeadCell]);
+    live.push_back(nodes[kLiveCell]);
+    NodeId newRoot = copyReachable(root, live, remap);
+    for (NodeId& id : pinned) {
+        id = copyReachable(id, live, remap);
+    }
+
+    // Запомненные результаты сохраняем, если их узлы тоже уцелели
+    for (NodeId id = 2; id < nodes.size(); ++id) {
+        NodeId result = nodes[id].result;
+        if (remap[id] != kNoNode && result != kNoNode && remap[result] != kNoNode) {
+            live[remap[id]].result = remap[result];
+        }
+    }
+
+    nodes = std::move(live);
+    root = newRoot;
+    emptyNodes.clear();
+
+    std::size_t slots = 1024;
+    while (slots < nodes.size() * 2) {
+        slots *= 2;
+    }
+    rehash(slots);
+    ++gcCount;
+}
+
+void HashLife::readFromFile(const std::string& filename) {
+    if (readCells(filename, [this](std::int64_t x, std::int64_t y) { setCell(x, y, true); })) {
+        std::cout << "Game state loaded from file '" << filename << "'" << std::endl;
+    }
+}
+
+void HashLife::saveToFile(const std::string& filename, const std::string& name) const {
+    FileWriter outputFile(filename);
+    if (!outputFile.isOpen()) {
+        std::cerr << "Error: Unable to open output file '" << filename << "'" << std::endl;
+        return;
+    }
+
+    writeLife106Header(outputFile, name, rule);
+    forEachCell([&](std::int64_t x, std::int64_t y) {
+        outputFile.writeInt(x);
+        outputFile.put(' ');
+        outputFile.writeInt(y);
+        outputFile.put('\n');
+    });
+    if (!outputFile.close()) {
+        std::cerr << "Error: Unable to write output file '" << filename << "'" << std::endl;
+        return;
+    }
+
+    std::cout << "Game state saved to file '" << filename << "'" << std::endl;
+}
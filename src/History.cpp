@@ -0,0 +1,131 @@
+#include "include/History.h"
+#include <algorithm>
+
+namespace {
+
+void putVarint(std::vector<std::uint8_t>& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(value));
+}
+
+std::uint64_t getVarint(const std::uint8_t*& p) {
+    std::uint64_t value = 0;
+    for (int shift = 0;; shift += 7) {
+        std::uint8_t byte = *p++;
+        value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return value;
+        }
+    }
+}
+
+// Применить одну разность к словам words; возвращает указатель на следующую запись
+const std::uint8_t* applyDelta(const std::uint8_t* p, Grid::Word* words) {
+    std::uint64_t changed = getVarint(p);
+    std::size_t index = 0;
+    for (std::uint64_t i = 0; i < changed; ++i) {
+        index += getVarint(p);
+        std::uint8_t mask = *p++;
+        Grid::Word value = 0;
+        for (int byte = 0; byte < 8; ++byte) {
+            if (mask & (1u << byte)) {
+                value |= static_cast<Grid::Word>(*p++) << (byte * 8);
+            }
+        }
+        words[index++] ^= value;
+    }
+    return p;
+}
+
+} // namespace
+
+History::History(int keyframeInterval) : interval(std::max(1, keyframeInterval)) {}
+
+void History::clear() {
+    data.clear();
+    keyframes.clear();
+    previous = Grid();
+    last = 0;
+    recorded = 0;
+}
+
+void History::appendDelta(const Grid::Word* before, const Grid::Word* after, std::size_t words) {
+    // Число изменившихся слов пишется перед ними: сначала считаем, потом кодируем
+    std::uint64_t changed = 0;
+    for (std::size_t i = 0; i < words; ++i) {
+        changed += (before ? before[i] : 0) != after[i];
+    }
+    putVarint(data, changed);
+
+    std::size_t next = 0; // Номер слова сразу за последним записанным
+    for (std::size_t i = 0; i < words; ++i) {
+        Grid::Word diff = (before ? before[i] : 0) ^ after[i];
+        if (diff == 0) {
+            continue;
+        }
+        putVarint(data, i - next);
+        next = i + 1;
+        std::size_t maskPosition = data.size();
+        data.push_back(0);
+        for (int byte = 0; byte < 8; ++byte) {
+            std::uint8_t value = static_cast<std::uint8_t>(diff >> (byte * 8));
+            if (value != 0) {
+                data[maskPosition] |= static_cast<std::uint8_t>(1u << byte);
+                data.push_back(value);
+            }
+        }
+    }
+}
+
+void History::record(const Grid& grid, long long generation) {
+    if (!keyframes.empty() &&
+        (generation <= last || grid.rows() != previous.rows() || grid.cols() != previous.cols())) {
+        clear();
+    }
+
+    const bool keyframe = keyframes.empty() || generation != last + 1 ||
+                          keyframes.back().count >= static_cast<std::size_t>(interval);
+    if (keyframe) {
+        keyframes.push_back({generation, data.size(), 0});
+        appendDelta(nullptr, grid.data(), grid.wordCount());
+    } else {
+        appendDelta(previous.data(), grid.data(), grid.wordCount());
+    }
+    ++keyframes.back().count;
+    ++recorded;
+    last = generation;
+    previous = grid;
+}
+
+bool History::seek(long long generation, Grid& grid) const {
+    // Последний ключевой кадр не позже нужного поколения
+    auto after = std::upper_bound(keyframes.begin(), keyframes.end(), generation,
+                                  [](long long value, const Keyframe& frame) { return value < frame.generation; });
+    if (after == keyframes.begin()) {
+        return false;
+    }
+    const Keyframe& frame = *(after - 1);
+    const long long steps = generation - frame.generation;
+    if (steps >= static_cast<long long>(frame.count)) {
+        return false;
+    }
+
+    if (grid.rows() != previous.rows() || grid.cols() != previous.cols()) {
+        grid.resize(previous.rows(), previous.cols());
+    } else {
+        grid.clear();
+    }
+    Grid::Word* words = grid.data();
+    const std::uint8_t* p = data.data() + frame.offset;
+    for (long long i = 0; i <= steps; ++i) {
+        p = applyDelta(p, words);
+    }
+    return true;
+}
+
+std::size_t History::memoryBytes() const {
+    return data.capacity() + keyframes.capacity() * sizeof(Keyframe) + previous.memoryBytes();
+}
@@ -0,0 +1,213 @@
+#include "include/InfinitePlane.h"
+#include "include/LifeFile.h"
+#include <algorithm>
+#include <bitset>
+#include <iostream>
+#include <stdexcept>
+
+namespace {
+
+// Деление с округлением вниз, чтобы отрицательные координаты попадали в свои плитки
+std::int64_t floorDiv(std::int64_t value, std::int64_t divisor) {
+    std::int64_t quotient = value / divisor;
+    return (value % divisor != 0 && value < 0) ? quotient - 1 : quotient;
+}
+
+} // namespace
+
+InfinitePlane::InfinitePlane(const RuleMasks& rule) : rule(rule) {
+    // Рождение при нуле соседей заполнило бы всю бесконечную плоскость
+    if (rule.birth & 1u) {
+        throw std::runtime_error("Infinite plane does not support rules with B0");
+    }
+}
+
+const InfinitePlane::Tile* InfinitePlane::findTile(std::int64_t x, std::int64_t y) const {
+    auto it = tiles.find({x, y});
+    return it == tiles.end() ? nullptr : &it->second;
+}
+
+void InfinitePlane::setCell(std::int64_t x, std::int64_t y, bool alive) {
+    TileKey key{floorDiv(x, kTileSize), floorDiv(y, kTileSize)};
+    int col = static_cast<int>(x - key.x * kTileSize);
+    int row = static_cast<int>(y - key.y * kTileSize);
+    Grid::Word bit = Grid::Word(1) << col;
+
+    if (alive) {
+        tiles[key][row] |= bit;
+        return;
+    }
+
+    auto it = tiles.find(key);
+    if (it == tiles.end()) {
+        return;
+    }
+    it->second[row] &= ~bit;
+    if (std::all_of(it->second.begin(), it->second.end(), [](Grid::Word word) { return word == 0; })) {
+        tiles.erase(it);
+    }
+}
+
+bool InfinitePlane::getCell(std::int64_t x, std::int64_t y) const {
+    std::int64_t tileX = floorDiv(x, kTileSize);
+    std::int64_t tileY = floorDiv(y, kTileSize);
+    const Tile* tile = findTile(tileX, tileY);
+    if (tile == nullptr) {
+        return false;
+    }
+    return ((*tile)[y - tileY * kTileSize] >> (x - tileX * kTileSize)) & 1u;
+}
+
+// Новое состояние плитки по ней самой и восьми соседям; false — плитка пуста
+bool InfinitePlane::computeTile(const TileKey& key, Tile& out) const {
+    static const Tile emptyTile{};
+    const Tile* around[3][3];
+    for (int dy = -1; dy <= 1; ++dy) {
+        for (int dx = -1; dx <= 1; ++dx) {
+            const Tile* tile = findTile(key.x + dx, key.y + dy);
+            around[dy + 1][dx + 1] = tile != nullptr ? tile : &emptyTile;
+        }
+    }
+
+    Grid::Word any = 0;
+    for (int row = 0; row < kTileSize; ++row) {
+        Grid::Word west[3], center[3], east[3];
+        for (int i = 0; i < 3; ++i) {
+            // Строка row - 1 + i; строки за краем плитки берутся из плиток сверху и снизу
+            int sourceRow = row - 1 + i;
+            int band = 1;
+            if (sourceRow < 0) {
+                band = 0;
+                sourceRow += kTileSize;
+            } else if (sourceRow >= kTileSize) {
+                band = 2;
+                sourceRow -= kTileSize;
+            }
+            Grid::Word word = (*around[band][1])[sourceRow];
+            west[i] = (word << 1) | ((*around[band][0])[sourceRow] >> 63);
+            east[i] = (word >> 1) | ((*around[band][2])[sourceRow] << 63);
+            center[i] = word;
+        }
+        out[row] = nextCells(west[0], center[0], east[0], west[1], center[1], east[1],
+                             west[2], center[2], east[2], rule);
+        any |= out[row];
+    }
+    return any != 0;
+}
+
+void InfinitePlane::step() {
+    // Кандидаты: все плитки и соседи, к которым примыкают живые клетки с края
+    candidates.clear();
+    for (const auto& [key, tile] : tiles) {
+        candidates.push_back(key);
+
+        Grid::Word leftColumn = 0, rightColumn = 0;
+        for (Grid::Word word : tile) {
+            leftColumn |= word & 1u;
+            rightColumn |= word >> 63;
+        }
+        const Grid::Word top = tile[0];
+        const Grid::Word bottom = tile[kTileSize - 1];
+
+        if (top != 0) candidates.push_back({key.x, key.y - 1});
+        if (bottom != 0) candidates.push_back({key.x, key.y + 1});
+        if (leftColumn != 0) candidates.push_back({key.x - 1, key.y});
+        if (rightColumn != 0) candidates.push_back({key.x + 1, key.y});
+        if (top & 1u) candidates.push_back({key.x - 1, key.y - 1});
+        if (top >> 63) candidates.push_back({key.x + 1, key.y - 1});
+        if (bottom & 1u) candidates.push_back({key.x - 1, key.y + 1});
+        if (bottom >> 63) candidates.push_back({key.x + 1, key.y + 1});
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    // Пустые плитки в новое поколение не попадают и освобождаются
+    nextTiles.clear();
+    Tile next;
+    for (const TileKey& key : candidates) {
+        if (computeTile(key, next)) {
+            nextTiles.emplace(key, next);
+        }
+    }
+    tiles.swap(nextTiles);
+    ++generationCount;
+}
+
+void InfinitePlane::advance(std::uint64_t generations) {
+    for (std::uint64_t i = 0; i < generations; ++i) {
+        step();
+    }
+}
+
+std::uint64_t InfinitePlane::population() const {
+    std::uint64_t count = 0;
+    for (const auto& entry : tiles) {
+        for (Grid::Word word : entry.second) {
+            count += std::bitset<64>(word).count();
+        }
+    }
+    return count;
+}
+
+std::size_t InfinitePlane::memoryBytes() const {
+    // Плитка плюс служебные данные узла хеш-таблицы
+    return tiles.size() * (sizeof(Tile) + sizeof(TileKey) + 2 * sizeof(void*)) +
+           tiles.bucket_count() * sizeof(void*);
+}
+
+std::vector<InfinitePlane::TileKey> InfinitePlane::sortedKeys() const {
+    std::vector<TileKey> keys;
+    keys.reserve(tiles.size());
+    for (const auto& entry : tiles) {
+        keys.push_back(entry.first);
+    }
+    std::sort(keys.begin(), keys.end());
+    return keys;
+}
+
+void InfinitePlane::loadFromGrid(const Grid& grid) {
+    for (int row = 0; row < grid.rows(); ++row) {
+        for (int col = 0; col < grid.cols(); ++col) {
+            if (grid.get(row, col)) {
+                setCell(col, row, true);
+            }
+        }
+    }
+}
+
+void InfinitePlane::copyToGrid(Grid& grid) const {
+    grid.clear();
+    forEachCell([&](std::int64_t x, std::int64_t y) {
+        if (x >= 0 && x < grid.cols() && y >= 0 && y < grid.rows()) {
+            grid.set(static_cast<int>(y), static_cast<int>(x), true);
+        }
+    });
+}
+
+void InfinitePlane::readFromFile(const std::string& filename) {
+    if (readCells(filename, [this](std::int64_t x, std::int64_t y) { setCell(x, y, true); })) {
+        std::cout << "Game state loaded from file '" << filename << "'" << std::endl;
+    }
+}
+
+void InfinitePlane::saveToFile(const std::string& filename, const std::string& name) const {
+    FileWriter outputFile(filename);
+    if (!outputFile.isOpen()) {
+        std::cerr << "Error: Unable to open output file '" << filename << "'" << std::endl;
+        return;
+    }
+
+    writeLife106Header(outputFile, name, rule);
+    forEachCell([&](std::int64_t x, std::int64_t y) {
+        outputFile.writeInt(x);
+        outputFile.put(' ');
+        outputFile.writeInt(y);
+        outputFile.put('\n');
+    });
+    if (!outputFile.close()) {
+        std::cerr << "Error: Unable to write output file '" << filename << "'" << std::endl;
+        return;
+    }
+
+    std::cout << "Game state saved to file '" << filename << "'" << std::endl;
+}
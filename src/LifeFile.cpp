@@ -0,0 +1,583 @@
+#include "include/LifeFile.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr std::size_t kMaxRleLine = 70; // Длина строки RLE по стандарту формата
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// Первая клетка со значением value в строке поля, начиная со столбца from (cols — такой нет)
+int nextCell(const Grid::Word* row, int words, int cols, int from, bool value) {
+    if (from >= cols) {
+        return cols;
+    }
+    int word = from / Grid::kWordBits;
+    Grid::Word bits = (value ? row[word] : ~row[word]) & (~Grid::Word(0) << (from % Grid::kWordBits));
+    while (bits == 0) {
+        if (++word == words) {
+            return cols;
+        }
+        bits = value ? row[word] : ~row[word];
+    }
+    return std::min(word * Grid::kWordBits + __builtin_ctzll(bits), cols);
+}
+
+// Разобрать цифры правила (0-8) в маску; false — в строке есть другие символы
+bool parseCounts(const std::string& text, std::uint16_t& mask) {
+    mask = 0;
+    for (char c : text) {
+        if (c < '0' || c > '8') {
+            return false;
+        }
+        mask |= 1u << (c - '0');
+    }
+    return true;
+}
+
+} // namespace
+
+std::string formatRule(const RuleMasks& rule) {
+    std::string text = "B";
+    for (int i = 0; i <= 8; ++i) {
+        if (rule.birth & (1u << i)) {
+            text += static_cast<char>('0' + i);
+        }
+    }
+    text += "/S";
+    for (int i = 0; i <= 8; ++i) {
+        if (rule.survival & (1u << i)) {
+            text += static_cast<char>('0' + i);
+        }
+    }
+    return text;
+}
+
+bool parseRuleMasks(const std::string& text, RuleMasks& rule) {
+    std::size_t slash = text.find('/');
+    if (slash == std::string::npos) {
+        return false;
+    }
+    std::string first = text.substr(0, slash);
+    std::string second = text.substr(slash + 1);
+    bool birthFirst = true;
+    if (!first.empty() && (first[0] == 'B' || first[0] == 'b') && !second.empty() &&
+        (second[0] == 'S' || second[0] == 's')) {
+        first.erase(0, 1);
+        second.erase(0, 1);
+    } else if (!first.empty() && (first[0] == 'S' || first[0] == 's') && !second.empty() &&
+               (second[0] == 'B' || second[0] == 'b')) {
+        first.erase(0, 1);
+        second.erase(0, 1);
+        birthFirst = false;
+    } else {
+        // Старая запись без букв: выживание/рождение
+        birthFirst = false;
+    }
+
+    RuleMasks parsed;
+    if (!parseCounts(birthFirst ? first : second, parsed.birth) ||
+        !parseCounts(birthFirst ? second : first, parsed.survival)) {
+        return false;
+    }
+    rule = parsed;
+    return true;
+}
+
+MappedFile::MappedFile(const std::string& filename) {
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+    struct stat info;
+    if (::fstat(fd, &info) == 0 && S_ISREG(info.st_mode)) {
+        opened = true;
+        length = static_cast<std::size_t>(info.st_size);
+        if (length > 0) {
+            void* mapped = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped == MAP_FAILED) {
+                opened = false;
+                length = 0;
+            } else {
+                ::madvise(mapped, length, MADV_SEQUENTIAL);
+                data = static_cast<const char*>(mapped);
+            }
+        }
+    }
+    ::close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (data != nullptr) {
+        ::munmap(const_cast<char*>(data), length);
+    }
+}
+
+FileWriter::FileWriter(const std::string& filename) : file(std::fopen(filename.c_str(), "wb")), buffer(1 << 16) {}
+
+void FileWriter::write(const char* text, std::size_t size) {
+    if (size > buffer.size() - used) {
+        flush();
+        if (size > buffer.size()) {
+            failed = failed || std::fwrite(text, 1, size, file) != size;
+            return;
+        }
+    }
+    std::memcpy(buffer.data() + used, text, size);
+    used += size;
+}
+
+void FileWriter::writeInt(std::int64_t value) {
+    char digits[24];
+    char* end = std::to_chars(digits, digits + sizeof(digits), value).ptr;
+    write(digits, static_cast<std::size_t>(end - digits));
+}
+
+void FileWriter::flush() {
+    if (used > 0 && file != nullptr) {
+        failed = failed || std::fwrite(buffer.data(), 1, used, file) != used;
+    }
+    used = 0;
+}
+
+bool FileWriter::close() {
+    if (file == nullptr) {
+        return false;
+    }
+    flush();
+    failed = std::fclose(file) != 0 || failed;
+    file = nullptr;
+    return !failed;
+}
+
+bool readLife106(const std::string& filename, const std::function<void(std::int64_t x, std::int64_t y)>& cell) {
+    MappedFile input(filename);
+    if (!input.isOpen()) {
+        std::cerr << "Error: Unable to open input file '" << filename << "'" << std::endl;
+        return false;
+    }
+
+    // Разбор прямо по отображенному файлу, без копирования строк
+    const char* end = input.end();
+    for (const char* p = input.begin(); p < end;) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', static_cast<std::size_t>(end - p)));
+        if (lineEnd == nullptr) {
+            lineEnd = end;
+        }
+        while (p < lineEnd && isSpace(*p)) {
+            ++p;
+        }
+        if (p < lineEnd && *p != '#') {
+            std::int64_t x, y;
+            auto parsedX = std::from_chars(p, lineEnd, x);
+            if (parsedX.ec == std::errc()) {
+                p = parsedX.ptr;
+                while (p < lineEnd && isSpace(*p)) {
+                    ++p;
+                }
+                if (std::from_chars(p, lineEnd, y).ec == std::errc()) {
+                    cell(x, y);
+                }
+            }
+        }
+        p = lineEnd + 1;
+    }
+    return true;
+}
+
+void writeLife106Header(FileWriter& out, const std::string& name, const RuleMasks& rule) {
+    out.write("#Life 1.06\n#N ");
+    out.write(name);
+    out.write("\n#R ");
+    out.write(formatRule(rule));
+    out.put('\n');
+}
+
+void writeLife106Cells(FileWriter& out, const Grid& grid) {
+    for (int row = 0; row < grid.rows(); ++row) {
+        const Grid::Word* words = grid.rowData(row);
+        for (int word = 0; word < grid.wordsPerRow(); ++word) {
+            for (Grid::Word bits = words[word]; bits != 0; bits &= bits - 1) {
+                out.writeInt(word * Grid::kWordBits + __builtin_ctzll(bits));
+                out.put(' ');
+                out.writeInt(row);
+                out.put('\n');
+            }
+        }
+    }
+}
+
+// Параметр rule заголовка RLE "x = m, y = n, rule = B3/S23"; пустая строка, если его нет
+static std::string rleHeaderRule(const std::string& header) {
+    std::size_t key = header.find("rule");
+    std::size_t equals = key == std::string::npos ? key : header.find('=', key);
+    if (equals != std::string::npos) {
+        std::size_t first = header.find_first_not_of(" \t", equals + 1);
+        std::size_t last = header.find_last_not_of(" \t\r,");
+        if (first != std::string::npos && last >= first) {
+            return header.substr(first, last - first + 1);
+        }
+    }
+    return std::string();
+}
+
+bool readRle(const std::string& filename, const std::function<void(std::int64_t x, std::int64_t y)>& cell,
+             std::string& rule) {
+    MappedFile input(filename);
+    if (!input.isOpen()) {
+        std::cerr << "Error: Unable to open input file '" << filename << "'" << std::endl;
+        return false;
+    }
+
+    bool headerSeen = false;
+    std::int64_t x = 0, y = 0, count = 0;
+    const char* end = input.end();
+    for (const char* p = input.begin(); p < end;) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', static_cast<std::size_t>(end - p)));
+        if (lineEnd == nullptr) {
+            lineEnd = end;
+        }
+        while (p < lineEnd && isSpace(*p)) {
+            ++p;
+        }
+
+        if (p < lineEnd && *p == '#') {
+            p = lineEnd + 1;
+            continue;
+        }
+        if (!headerSeen && p < lineEnd && *p == 'x') {
+            // Заголовок "x = m, y = n, rule = B3/S23": нужен только параметр rule
+            headerSeen = true;
+            std::string headerRule = rleHeaderRule(std::string(p, lineEnd));
+            if (!headerRule.empty()) {
+                rule = headerRule;
+            }
+            p = lineEnd + 1;
+            continue;
+        }
+
+        for (; p < lineEnd; ++p) {
+            char c = *p;
+            if (c >= '0' && c <= '9') {
+                count = count * 10 + (c - '0');
+                continue;
+            }
+            std::int64_t run = count == 0 ? 1 : count;
+            if (c == 'b' || c == '.') {
+                x += run;
+            } else if (c == '$') {
+                y += run;
+                x = 0;
+            } else if (c == '!') {
+                return true;
+            } else if (c == 'o' || (c >= 'A' && c <= 'Z')) {
+                for (std::int64_t i = 0; i < run; ++i) {
+                    cell(x++, y);
+                }
+            } else {
+                continue; // Пробелы и неизвестные символы не сбрасывают счетчик
+            }
+            count = 0;
+        }
+        p = lineEnd + 1;
+    }
+    return true;
+}
+
+bool writeRle(const std::string& filename, const Grid& grid, const std::string& name, const RuleMasks& rule) {
+    return writeRle(filename, grid, name, formatRule(rule));
+}
+
+bool writeRle(const std::string& filename, const Grid& grid, const std::string& name, const std::string& rule) {
+    FileWriter out(filename);
+    if (!out.isOpen()) {
+        std::cerr << "Error: Unable to open output file '" << filename << "'" << std::endl;
+        return false;
+    }
+
+    out.write("#N ");
+    out.write(name);
+    out.write("\nx = ");
+    out.writeInt(grid.cols());
+    out.write(", y = ");
+    out.writeInt(grid.rows());
+    out.write(", rule = ");
+    out.write(rule);
+    out.put('\n');
+
+    std::size_t lineLength = 0;
+    auto emit = [&](std::int64_t run, char tag) {
+        char token[24];
+        char* tokenEnd = token;
+        if (run > 1) {
+            tokenEnd = std::to_chars(token, token + sizeof(token) - 1, run).ptr;
+        }
+        *tokenEnd++ = tag;
+        std::size_t size = static_cast<std::size_t>(tokenEnd - token);
+        if (lineLength + size > kMaxRleLine) {
+            out.put('\n');
+            lineLength = 0;
+        }
+        out.write(token, size);
+        lineLength += size;
+    };
+
+    // Мертвые клетки в конце строки не пишутся, пустые строки объединяются в один "N$"
+    std::int64_t pendingRows = 0;
+    for (int row = 0; row < grid.rows(); ++row) {
+        const Grid::Word* words = grid.rowData(row);
+        for (int col = 0;;) {
+            int live = nextCell(words, grid.wordsPerRow(), grid.cols(), col, true);
+            if (live >= grid.cols()) {
+                break;
+            }
+            if (pendingRows > 0) {
+                emit(pendingRows, '$');
+                pendingRows = 0;
+            }
+            if (live > col) {
+                emit(live - col, 'b');
+            }
+            col = nextCell(words, grid.wordsPerRow(), grid.cols(), live, false);
+            emit(col - live, 'o');
+        }
+        ++pendingRows;
+    }
+    out.write("!\n");
+
+    if (!out.close()) {
+        std::cerr << "Error: Unable to write output file '" << filename << "'" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+std::uint64_t gridChecksumStart(std::size_t count) {
+    return 0x9E3779B97F4A7C15ull ^ count;
+}
+
+std::uint64_t gridChecksumUpdate(std::uint64_t hash, const Grid::Word* words, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        hash = (hash ^ words[i]) * 0xBF58476D1CE4E5B9ull;
+        hash ^= hash >> 31;
+    }
+    return hash;
+}
+
+std::uint64_t gridChecksum(const Grid::Word* words, std::size_t count) {
+    return gridChecksumUpdate(gridChecksumStart(count), words, count);
+}
+
+std::size_t snapshotWordCount(const SnapshotHeader& header) {
+    return static_cast<std::size_t>(header.rows) * ((header.cols + Grid::kWordBits - 1) / Grid::kWordBits);
+}
+
+// Проверка заголовка снимка длиной fileSize байт; пустая строка — заголовок верный
+static std::string checkSnapshotHeader(const SnapshotHeader& header, std::uint64_t fileSize) {
+    if (fileSize < sizeof(header) || std::memcmp(header.magic, kSnapshotMagic, sizeof(header.magic)) != 0) {
+        return "not a snapshot file";
+    }
+    if (header.byteOrder != kByteOrderMark) {
+        return "snapshot was written on a machine with a different byte order";
+    }
+    if (header.rows == 0 || header.cols == 0 || header.rows > 0x7FFFFFFFu || header.cols > 0x7FFFFFFFu) {
+        return "invalid field size";
+    }
+    // Размер из заголовка сверяется с длиной файла до того, как под поле выделяется память
+    std::uint64_t bytes = sizeof(header) + static_cast<std::uint64_t>(snapshotWordCount(header)) * sizeof(Grid::Word) +
+                          ((header.flags & kHasChecksum) ? sizeof(std::uint64_t) : 0);
+    if (bytes > fileSize) {
+        return "file is truncated";
+    }
+    return std::string();
+}
+
+bool readSnapshotHeader(const std::string& filename, SnapshotHeader& header) {
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Error: Unable to open input file '" << filename << "'" << std::endl;
+        return false;
+    }
+
+    struct stat info;
+    std::string error = "not a snapshot file";
+    if (::fstat(fd, &info) == 0 && ::pread(fd, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header))) {
+        error = checkSnapshotHeader(header, static_cast<std::uint64_t>(info.st_size));
+    }
+    ::close(fd);
+
+    if (!error.empty()) {
+        std::cerr << "Error: Invalid snapshot '" << filename << "': " << error << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool writeSnapshot(const std::string& filename, const Grid& grid, const RuleMasks& rule, std::uint64_t generation,
+                   bool withChecksum) {
+    std::FILE* file = std::fopen(filename.c_str(), "wb");
+    if (file == nullptr) {
+        std::cerr << "Error: Unable to open output file '" << filename << "'" << std::endl;
+        return false;
+    }
+
+    SnapshotHeader header{};
+    std::memcpy(header.magic, kSnapshotMagic, sizeof(header.magic));
+    header.byteOrder = kByteOrderMark;
+    header.rows = static_cast<std::uint32_t>(grid.rows());
+    header.cols = static_cast<std::uint32_t>(grid.cols());
+    header.birth = rule.birth;
+    header.survival = rule.survival;
+    header.flags = withChecksum ? kHasChecksum : 0;
+    header.generation = generation;
+
+    // Слова поля пишутся одним блоком прямо из памяти поля
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+    ok = ok && std::fwrite(grid.data(), sizeof(Grid::Word), grid.wordCount(), file) == grid.wordCount();
+    if (withChecksum) {
+        std::uint64_t checksum = gridChecksum(grid.data(), grid.wordCount());
+        ok = ok && std::fwrite(&checksum, sizeof(checksum), 1, file) == 1;
+    }
+    ok = std::fclose(file) == 0 && ok;
+
+    if (!ok) {
+        std::cerr << "Error: Unable to write output file '" << filename << "'" << std::endl;
+    }
+    return ok;
+}
+
+bool readSnapshot(const std::string& filename, Grid& grid, RuleMasks& rule, std::uint64_t& generation) {
+    MappedFile input(filename);
+    if (!input.isOpen()) {
+        std::cerr << "Error: Unable to open input file '" << filename << "'" << std::endl;
+        return false;
+    }
+
+    // Проверки идут по отображению файла, так что отдельная копия поля не нужна:
+    // слова копируются прямо в поле и только после того, как снимок признан верным
+    SnapshotHeader header{};
+    if (input.size() >= sizeof(header)) {
+        std::memcpy(&header, input.begin(), sizeof(header));
+    }
+    std::string error = checkSnapshotHeader(header, input.size());
+    const Grid::Word* words = reinterpret_cast<const Grid::Word*>(input.begin() + sizeof(header));
+    const std::size_t count = error.empty() ? snapshotWordCount(header) : 0;
+    if (error.empty() && (header.flags & kHasChecksum)) {
+        std::uint64_t checksum;
+        std::memcpy(&checksum, words + count, sizeof(checksum));
+        if (checksum != gridChecksum(words, count)) {
+            error = "checksum mismatch";
+        }
+    }
+    if (error.empty()) {
+        // Неиспользуемые биты в конце строк должны оставаться нулевыми
+        const std::size_t rowWords = count / header.rows;
+        const Grid::Word tail = header.cols % Grid::kWordBits == 0
+                                    ? ~Grid::Word(0)
+                                    : (Grid::Word(1) << (header.cols % Grid::kWordBits)) - 1;
+        for (std::size_t row = 0; row < header.rows && error.empty(); ++row) {
+            if (words[(row + 1) * rowWords - 1] & ~tail) {
+                error = "cells outside the field";
+            }
+        }
+    }
+    if (!error.empty()) {
+        std::cerr << "Error: Invalid snapshot '" << filename << "': " << error << std::endl;
+        return false;
+    }
+
+    // Копирование в поле, а не обмен буферов: счетчик изменений поля (Grid::version) должен только расти
+    grid.resize(static_cast<int>(header.rows), static_cast<int>(header.cols));
+    std::memcpy(grid.data(), words, count * sizeof(Grid::Word));
+    rule = RuleMasks{header.birth, header.survival};
+    generation = header.generation;
+    return true;
+}
+
+bool readFileRule(const std::string& filename, std::string& rule) {
+    rule.clear();
+    auto endsWith = [&](const char* suffix) {
+        std::size_t length = std::strlen(suffix);
+        return filename.size() >= length && filename.compare(filename.size() - length, length, suffix) == 0;
+    };
+
+    if (endsWith(".rle")) {
+        // Правило стоит в строке заголовка, до нее — только комментарии
+        MappedFile input(filename);
+        if (!input.isOpen()) {
+            return false;
+        }
+        const char* end = input.end();
+        for (const char* p = input.begin(); p < end;) {
+            const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', static_cast<std::size_t>(end - p)));
+            if (lineEnd == nullptr) {
+                lineEnd = end;
+            }
+            while (p < lineEnd && isSpace(*p)) {
+                ++p;
+            }
+            if (p < lineEnd && *p != '#') {
+                if (*p == 'x') {
+                    rule = rleHeaderRule(std::string(p, lineEnd));
+                }
+                break;
+            }
+            p = lineEnd + 1;
+        }
+        return true;
+    }
+    if (endsWith(".snap")) {
+        std::FILE* file = std::fopen(filename.c_str(), "rb");
+        if (file == nullptr) {
+            return false;
+        }
+        SnapshotHeader header;
+        bool ok = std::fread(&header, sizeof(header), 1, file) == 1 &&
+                  std::memcmp(header.magic, kSnapshotMagic, sizeof(header.magic)) == 0;
+        std::fclose(file);
+        if (ok) {
+            rule = formatRule(RuleMasks{header.birth, header.survival});
+        }
+        return ok;
+    }
+    return true;
+}
+
+bool readCells(const std::string& filename, const std::function<void(std::int64_t x, std::int64_t y)>& cell) {
+    auto endsWith = [&](const char* suffix) {
+        std::size_t length = std::strlen(suffix);
+        return filename.size() >= length && filename.compare(filename.size() - length, length, suffix) == 0;
+    };
+
+    if (endsWith(".rle")) {
+        std::string rule;
+        return readRle(filename, cell, rule);
+    }
+    if (endsWith(".snap")) {
+        Grid grid;
+        RuleMasks rule;
+        std::uint64_t generation;
+        if (!readSnapshot(filename, grid, rule, generation)) {
+            return false;
+        }
+        for (int row = 0; row < grid.rows(); ++row) {
+            const Grid::Word* words = grid.rowData(row);
+            for (int word = 0; word < grid.wordsPerRow(); ++word) {
+                for (Grid::Word bits = words[word]; bits != 0; bits &= bits - 1) {
+                    cell(word * Grid::kWordBits + __builtin_ctzll(bits), row);
+                }
+            }
+        }
+        return true;
+    }
+    return readLife106(filename, cell);
+}
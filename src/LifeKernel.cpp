@@ -0,0 +1,61 @@
+#include "include/LifeKernel.h"
+
+namespace {
+
+template <typename Rule>
+void stepRowScalarWith(const Rule& rule, const Grid::Word* up, const Grid::Word* mid, const Grid::Word* down,
+                       Grid::Word* out, int cols, int wordBegin, int wordEnd) {
+    const int words = (cols + Grid::kWordBits - 1) / Grid::kWordBits;
+    const int tailBits = cols % Grid::kWordBits;
+    const Grid::Word tailMask = tailBits == 0 ? ~Grid::Word(0) : (Grid::Word(1) << tailBits) - 1;
+
+    for (int i = wordBegin; i < wordEnd; ++i) {
+        Grid::Word next = nextCells(westNeighbors(up, i, words, cols), up[i], eastNeighbors(up, i, words, cols),
+                                    westNeighbors(mid, i, words, cols), mid[i], eastNeighbors(mid, i, words, cols),
+                                    westNeighbors(down, i, words, cols), down[i], eastNeighbors(down, i, words, cols),
+                                    rule);
+        // Биты за пределами поля должны оставаться нулевыми
+        out[i] = i == words - 1 ? next & tailMask : next;
+    }
+}
+
+template <std::uint16_t Birth, std::uint16_t Survival>
+struct ScalarFixedKernel {
+    static void step(const Grid::Word* up, const Grid::Word* mid, const Grid::Word* down,
+                     Grid::Word* out, int cols, int wordBegin, int wordEnd, const RuleMasks&) {
+        stepRowScalarWith(FixedRule<Birth, Survival>(), up, mid, down, out, cols, wordBegin, wordEnd);
+    }
+};
+
+} // namespace
+
+void stepRowScalar(const Grid::Word* up, const Grid::Word* mid, const Grid::Word* down,
+                   Grid::Word* out, int cols, int wordBegin, int wordEnd, const RuleMasks& rule) {
+    stepRowScalarWith(rule, up, mid, down, out, cols, wordBegin, wordEnd);
+}
+
+RowKernel findRowKernelScalar(const RuleMasks& rule) {
+    return findFixedKernel<ScalarFixedKernel>(rule);
+}
+
+const std::vector<KernelInfo>& availableKernels() {
+    static const std::vector<KernelInfo> kernels = [] {
+        std::vector<KernelInfo> result = {{"scalar", stepRowScalar, findRowKernelScalar}};
+#ifdef GOL_HAVE_AVX2
+        if (__builtin_cpu_supports("avx2")) {
+            result.push_back({"avx2", stepRowAvx2, findRowKernelAvx2});
+        }
+#endif
+#ifdef GOL_HAVE_AVX512
+        if (__builtin_cpu_supports("avx512f")) {
+            result.push_back({"avx512", stepRowAvx512, findRowKernelAvx512});
+        }
+#endif
+        return result;
+    }();
+    return kernels;
+}
+
+const KernelInfo& activeKernel() {
+    return availableKernels().back();
+}
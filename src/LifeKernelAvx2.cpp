@@ -0,0 +1,76 @@
+#include "include/LifeKernel.h"
+#include <immintrin.h>
+
+// Ядро на AVX2: 256 клеток (4 слова) за одну векторную операцию.
+// Этот файл компилируется с -mavx2 и вызывается только после проверки CPUID.
+
+namespace {
+
+struct Vec256 {
+    __m256i v;
+};
+
+inline Vec256 operator&(Vec256 a, Vec256 b) { return {_mm256_and_si256(a.v, b.v)}; }
+inline Vec256 operator|(Vec256 a, Vec256 b) { return {_mm256_or_si256(a.v, b.v)}; }
+inline Vec256 operator^(Vec256 a, Vec256 b) { return {_mm256_xor_si256(a.v, b.v)}; }
+inline Vec256 operator~(Vec256 a) { return {_mm256_xor_si256(a.v, _mm256_set1_epi64x(-1))}; }
+
+inline Vec256 load(const Grid::Word* p) {
+    return {_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))};
+}
+
+// Запад: сдвиг влево на один бит с переносом старшего бита предыдущего слова
+inline Vec256 west(const Grid::Word* p) {
+    return {_mm256_or_si256(_mm256_slli_epi64(load(p).v, 1), _mm256_srli_epi64(load(p - 1).v, 63))};
+}
+
+// Восток: сдвиг вправо на один бит с переносом младшего бита следующего слова
+inline Vec256 east(const Grid::Word* p) {
+    return {_mm256_or_si256(_mm256_srli_epi64(load(p).v, 1), _mm256_slli_epi64(load(p + 1).v, 63))};
+}
+
+// Ядро, параметризованное способом применения правила: маски во время выполнения или FixedRule
+template <typename Rule>
+void stepRowAvx2With(const Rule& evaluator, const Grid::Word* up, const Grid::Word* mid, const Grid::Word* down,
+                     Grid::Word* out, int cols, int wordBegin, int wordEnd, const RuleMasks& rule) {
+    constexpr int lanes = 4;
+    const int words = (cols + Grid::kWordBits - 1) / Grid::kWordBits;
+
+    // Первое и последнее слово строки требуют замыкания — их считает скалярное ядро по маскам rule
+    int vecBegin = wordBegin < 1 ? 1 : wordBegin;
+    int vecEnd = wordEnd > words - 1 ? words - 1 : wordEnd;
+    if (vecEnd - vecBegin < lanes) {
+        stepRowScalar(up, mid, down, out, cols, wordBegin, wordEnd, rule);
+        return;
+    }
+
+    stepRowScalar(up, mid, down, out, cols, wordBegin, vecBegin, rule);
+    int i = vecBegin;
+    for (; i + lanes <= vecEnd; i += lanes) {
+        Vec256 next = nextCells(west(up + i), load(up + i), east(up + i),
+                                west(mid + i), load(mid + i), east(mid + i),
+                                west(down + i), load(down + i), east(down + i),
+                                evaluator);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), next.v);
+    }
+    stepRowScalar(up, mid, down, out, cols, i, wordEnd, rule);
+}
+
+template <std::uint16_t Birth, std::uint16_t Survival>
+struct Avx2FixedKernel {
+    static void step(const Grid::Word* up, const Grid::Word* mid, const Grid::Word* down,
+                     Grid::Word* out, int cols, int wordBegin, int wordEnd, const RuleMasks& rule) {
+        stepRowAvx2With(FixedRule<Birth, Survival>(), up, mid, down, out, cols, wordBegin, wordEnd, rule);
+    }
+};
+
+} // namespace
+
+void stepRowAvx2(const Grid::Word* up, const Grid::Word* mid, const Grid::Word* down,
+                 Grid::Word* out, int cols, int wordBegin, int wordEnd, const RuleMasks& rule) {
+    stepRowAvx2With(rule, up, mid, down, out, cols, wordBegin, wordEnd, rule);
+}
+
+RowKernel findRowKernelAvx2(const RuleMasks& rule) {
+    return findFixedKernel<Avx2FixedKernel>(rule);
+}
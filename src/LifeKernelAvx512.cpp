@@ -0,0 +1,76 @@
+#include "include/LifeKernel.h"
+#include <immintrin.h>
+
+// Ядро на AVX-512: 512 клеток (8 слов) за одну векторную операцию.
+// Этот файл компилируется с -mavx512f и вызывается только после проверки CPUID.
+
+namespace {
+
+struct Vec512 {
+    __m512i v;
+};
+
+inline Vec512 operator&(Vec512 a, Vec512 b) { return {_mm512_and_si512(a.v, b.v)}; }
+inline Vec512 operator|(Vec512 a, Vec512 b) { return {_mm512_or_si512(a.v, b.v)}; }
+inline Vec512 operator^(Vec512 a, Vec512 b) { return {_mm512_xor_si512(a.v, b.v)}; }
+inline Vec512 operator~(Vec512 a) { return {_mm512_xor_si512(a.v, _mm512_set1_epi64(-1))}; }
+
+inline Vec512 load(const Grid::Word* p) {
+    return {_mm512_loadu_si512(reinterpret_cast<const __m512i*>(p))};
+}
+
+// Запад: сдвиг влево на один бит с переносом старшего бита предыдущего слова
+inline Vec512 west(const Grid::Word* p) {
+    return {_mm512_or_si512(_mm512_slli_epi64(load(p).v, 1), _mm512_srli_epi64(load(p - 1).v, 63))};
+}
+
+// Восток: сдвиг вправо на один бит с переносом младшего бита следующего слова
+inline Vec512 east(const Grid::Word* p) {
+    return {_mm512_or_si512(_mm512_srli_epi64(load(p).v, 1), _mm512_slli_epi64(load(p + 1).v, 63))};
+}
+
+// Ядро, параметризованное способом применения правила: маски во время выполнения или FixedRule
+template <typename Rule>
+void stepRowAvx512With(const Rule& evaluator, const Grid::Word* up, const Grid::Word* mid, const Grid::Word* down,
+                       Grid::Word* out, int cols, int wordBegin, int wordEnd, const RuleMasks& rule) {
+    constexpr int lanes = 8;
+    const int words = (cols + Grid::kWordBits - 1) / Grid::kWordBits;
+
+    // Первое и последнее слово строки требуют замыкания — их считает скалярное ядро по маскам rule
+    int vecBegin = wordBegin < 1 ? 1 : wordBegin;
+    int vecEnd = wordEnd > words - 1 ? words - 1 : wordEnd;
+    if (vecEnd - vecBegin < lanes) {
+        stepRowScalar(up, mid, down, out, cols, wordBegin, wordEnd, rule);
+        return;
+    }
+
+    stepRowScalar(up, mid, down, out, cols, wordBegin, vecBegin, rule);
+    int i = vecBegin;
+    for (; i + lanes <= vecEnd; i += lanes) {
+        Vec512 next = nextCells(west(up + i), load(up + i), east(up + i),
+                                west(mid + i), load(mid + i), east(mid + i),
+                                west(down + i), load(down + i), east(down + i),
+                                evaluator);
+        _mm512_storeu_si512(reinterpret_cast<__m512i*>(out + i), next.v);
+    }
+    stepRowScalar(up, mid, down, out, cols, i, wordEnd, rule);
+}
+
+template <std::uint16_t Birth, std::uint16_t Survival>
+struct Avx512FixedKernel {
+    static void step(const Grid::Word* up, const Grid::Word* mid, const Grid::Word* down,
+                     Grid::Word* out, int cols, int wordBegin, int wordEnd, const RuleMasks& rule) {
+        stepRowAvx512With(FixedRule<Birth, Survival>(), up, mid, down, out, cols, wordBegin, wordEnd, rule);
+    }
+};
+
+} // namespace
+
+void stepRowAvx512(const Grid::Word* up, const Grid::Word* mid, const Grid::Word* down,
+                   Grid::Word* out, int cols, int wordBegin, int wordEnd, const RuleMasks& rule) {
+    stepRowAvx512With(rule, up, mid, down, out, cols, wordBegin, wordEnd, rule);
+}
+
+RowKernel findRowKernelAvx512(const RuleMasks& rule) {
+    return findFixedKernel<Avx512FixedKernel>(rule);
+}
@@ -0,0 +1,332 @@
+#include "include/MappedGrid.h"
+#include "include/LifeFile.h"
+#include <algorithm>
+#include <bitset>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr std::size_t kHeaderBytes = sizeof(SnapshotHeader);
+constexpr std::size_t kBandBytes = std::size_t(8) << 20; // Размер полосы по умолчанию
+
+bool endsWith(const std::string& text, const char* suffix) {
+    std::size_t length = std::strlen(suffix);
+    return text.size() >= length && text.compare(text.size() - length, length, suffix) == 0;
+}
+
+// Скопировать bytes байт между файлами средствами ядра (без копии в памяти процесса).
+// Если ядро или файловая система этого не умеют, данные читаются прямо в отображение fallback
+bool copyFileRange(int from, loff_t fromOffset, int to, loff_t toOffset, std::size_t bytes, char* fallback) {
+    std::size_t done = 0;
+    while (done < bytes) {
+        ssize_t copied = ::copy_file_range(from, &fromOffset, to, &toOffset, bytes - done, 0);
+        if (copied <= 0) {
+            break;
+        }
+        done += static_cast<std::size_t>(copied);
+    }
+    while (done < bytes && fallback != nullptr) {
+        ssize_t copied = ::pread(from, fallback + done, bytes - done, fromOffset);
+        if (copied <= 0) {
+            return false;
+        }
+        done += static_cast<std::size_t>(copied);
+        fromOffset += copied;
+    }
+    return done == bytes;
+}
+
+} // namespace
+
+MappedGrid::~MappedGrid() {
+    close();
+}
+
+void MappedGrid::close() {
+    for (Buffer& buffer : buffers) {
+        if (buffer.base != nullptr) {
+            ::munmap(buffer.base, buffer.length);
+        }
+        if (buffer.fd >= 0) {
+            ::close(buffer.fd);
+        }
+        buffer = Buffer();
+    }
+    current = 0;
+}
+
+bool MappedGrid::map(Buffer& buffer, const std::string& path) {
+    buffer.path = path;
+    buffer.length = kHeaderBytes + static_cast<std::size_t>(numRows) * rowWords * sizeof(Grid::Word);
+    buffer.fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (buffer.fd < 0 || ::ftruncate(buffer.fd, static_cast<off_t>(buffer.length)) != 0) {
+        std::cerr << "Error: Unable to create mapped grid file '" << path << "': " << std::strerror(errno)
+                  << std::endl;
+        return false;
+    }
+    void* base = ::mmap(nullptr, buffer.length, PROT_READ | PROT_WRITE, MAP_SHARED, buffer.fd, 0);
+    if (base == MAP_FAILED) {
+        std::cerr << "Error: Unable to map '" << path << "': " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    buffer.base = static_cast<char*>(base);
+    ::madvise(buffer.base, buffer.length, MADV_SEQUENTIAL);
+    return true;
+}
+
+bool MappedGrid::create(const std::string& prefix, int rows, int cols) {
+    close();
+    if (rows <= 0 || cols <= 0) {
+        std::cerr << "Error: Invalid mapped grid size " << rows << "x" << cols << std::endl;
+        return false;
+    }
+    numRows = rows;
+    numCols = cols;
+    rowWords = (cols + Grid::kWordBits - 1) / Grid::kWordBits;
+    if (bandRows == 0) {
+        bandRows = static_cast<int>(std::max<std::size_t>(1, kBandBytes / (rowWords * sizeof(Grid::Word))));
+    }
+    generationCount = 0;
+    for (int i = 0; i < 2; ++i) {
+        if (!map(buffers[i], prefix + "." + std::to_string(i) + ".snap")) {
+            close();
+            return false;
+        }
+        writeHeader(buffers[i]);
+    }
+    return true;
+}
+
+bool MappedGrid::open(const std::string& prefix, const std::string& snapshotFilename) {
+    int input = ::open(snapshotFilename.c_str(), O_RDONLY);
+    if (input < 0) {
+        std::cerr << "Error: Unable to open input file '" << snapshotFilename << "'" << std::endl;
+        return false;
+    }
+
+    SnapshotHeader header;
+    bool ok = ::pread(input, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header)) &&
+              std::memcmp(header.magic, kSnapshotMagic, sizeof(header.magic)) == 0 &&
+              header.byteOrder == kByteOrderMark;
+    if (!ok) {
+        std::cerr << "Error: '" << snapshotFilename << "' is not a snapshot of this machine's byte order" << std::endl;
+    }
+    ok = ok && create(prefix, static_cast<int>(header.rows), static_cast<int>(header.cols));
+
+    const std::size_t wordBytes = buffers[0].length - kHeaderBytes;
+    if (ok && !copyFileRange(input, kHeaderBytes, buffers[0].fd, kHeaderBytes, wordBytes,
+                             buffers[0].base + kHeaderBytes)) {
+        std::cerr << "Error: Snapshot '" << snapshotFilename << "' is truncated" << std::endl;
+        ok = false;
+    }
+
+    // Проверки идут одним последовательным проходом по уже скопированным словам
+    if (ok) {
+        const Grid::Word* words = rowData(buffers[0], 0);
+        const std::size_t count = static_cast<std::size_t>(numRows) * rowWords;
+        Grid::Word tail = numCols % Grid::kWordBits == 0 ? ~Grid::Word(0)
+                                                         : (Grid::Word(1) << (numCols % Grid::kWordBits)) - 1;
+        for (int row = 0; row < numRows && ok; ++row) {
+            ok = (rowData(buffers[0], row)[rowWords - 1] & ~tail) == 0;
+        }
+        std::uint64_t checksum = 0;
+        if (ok && (header.flags & kHasChecksum) != 0) {
+            ok = ::pread(input, &checksum, sizeof(checksum), static_cast<off_t>(kHeaderBytes + wordBytes)) ==
+                     static_cast<ssize_t>(sizeof(checksum)) &&
+                 checksum == gridChecksum(words, count);
+        }
+        if (!ok) {
+            std::cerr << "Error: Snapshot '" << snapshotFilename << "' is corrupted" << std::endl;
+        }
+    }
+    ::close(input);
+
+    if (!ok) {
+        close();
+        return false;
+    }
+    ruleMasks = {header.birth, header.survival};
+    generationCount = header.generation;
+    writeHeader(buffers[0]);
+    return true;
+}
+
+bool MappedGrid::importCells(const std::string& filename) {
+    return readCells(filename, [&](std::int64_t x, std::int64_t y) {
+        if (x >= 0 && x < numCols && y >= 0 && y < numRows) {
+            set(static_cast<int>(y), static_cast<int>(x), true);
+        }
+    });
+}
+
+Grid::Word* MappedGrid::rowData(Buffer& buffer, int row) const {
+    return reinterpret_cast<Grid::Word*>(buffer.base + kHeaderBytes) + static_cast<std::size_t>(row) * rowWords;
+}
+
+const Grid::Word* MappedGrid::rowData(const Buffer& buffer, int row) const {
+    return reinterpret_cast<const Grid::Word*>(buffer.base + kHeaderBytes) +
+           static_cast<std::size_t>(row) * rowWords;
+}
+
+bool MappedGrid::get(int row, int col) const {
+    return (rowData(buffers[current], row)[col / Grid::kWordBits] >> (col % Grid::kWordBits)) & 1u;
+}
+
+void MappedGrid::set(int row, int col, bool alive) {
+    Grid::Word bit = Grid::Word(1) << (col % Grid::kWordBits);
+    Grid::Word& word = rowData(buffers[current], row)[col / Grid::kWordBits];
+    word = alive ? (word | bit) : (word & ~bit);
+}
+
+void MappedGrid::writeHeader(Buffer& buffer) {
+    SnapshotHeader header{};
+    std::memcpy(header.magic, kSnapshotMagic, sizeof(header.magic));
+    header.byteOrder = kByteOrderMark;
+    header.rows = static_cast<std::uint32_t>(numRows);
+    header.cols = static_cast<std::uint32_t>(numCols);
+    header.birth = ruleMasks.birth;
+    header.survival = ruleMasks.survival;
+    header.generation = generationCount;
+    std::memcpy(buffer.base, &header, sizeof(header));
+}
+
+void MappedGrid::setThreads(int threads) {
+    numThreads = std::max(1, threads);
+    pool = numThreads > 1 ? std::make_unique<ThreadPool>(numThreads) : nullptr;
+}
+
+void MappedGrid::advise(const Buffer& buffer, long long rowBegin, long long rowEnd, int advice) const {
+    const std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    const std::size_t rowBytes = static_cast<std::size_t>(rowWords) * sizeof(Grid::Word);
+    std::size_t begin = kHeaderBytes + static_cast<std::size_t>(rowBegin) * rowBytes;
+    std::size_t end = kHeaderBytes + static_cast<std::size_t>(rowEnd) * rowBytes;
+    if (advice == MADV_DONTNEED) {
+        begin = (begin + page - 1) / page * page;
+        end = end / page * page;
+    } else {
+        begin = begin / page * page;
+        end = std::min(buffer.length, (end + page - 1) / page * page);
+    }
+    if (begin < end) {
+        ::madvise(buffer.base + begin, end - begin, advice);
+    }
+}
+
+void MappedGrid::stepGeneration() {
+    Buffer& source = buffers[current];
+    Buffer& target = buffers[1 - current];
+    const RowKernel kernel = activeKernel().select(ruleMasks);
+
+    for (int band = 0; band < numRows; band += bandRows) {
+        const int bandEnd = std::min(numRows, band + bandRows);
+        // Следующая полоса читается с диска, пока считается текущая
+        advise(source, bandEnd, std::min(numRows, bandEnd + bandRows), MADV_WILLNEED);
+
+        const int tasks = std::min(numThreads, bandEnd - band);
+        auto stepRows = [&](int task) {
+            int rowBegin = band + static_cast<int>(static_cast<long long>(bandEnd - band) * task / tasks);
+            int rowEnd = band + static_cast<int>(static_cast<long long>(bandEnd - band) * (task + 1) / tasks);
+            for (int row = rowBegin; row < rowEnd; ++row) {
+                kernel(rowData(source, row == 0 ? numRows - 1 : row - 1), rowData(source, row),
+                       rowData(source, row + 1 == numRows ? 0 : row + 1), rowData(target, row), numCols, 0,
+                       rowWords, ruleMasks);
+            }
+        };
+        if (pool && tasks > 1) {
+            pool->parallelFor(tasks, stepRows);
+        } else {
+            stepRows(0);
+        }
+
+        // Строки источника выше bandEnd - 1 больше не нужны (кроме строки 0 для последней строки поля),
+        // готовая полоса результата остается только в страничном кэше и уходит на диск
+        advise(source, std::max(1, band - 1), bandEnd - 1, MADV_DONTNEED);
+        advise(target, band, bandEnd, MADV_DONTNEED);
+    }
+
+    current = 1 - current;
+    ++generationCount;
+    writeHeader(target);
+}
+
+void MappedGrid::advance(std::uint64_t generations) {
+    for (std::uint64_t i = 0; i < generations; ++i) {
+        stepGeneration();
+    }
+}
+
+std::uint64_t MappedGrid::population() const {
+    std::uint64_t count = 0;
+    for (int band = 0; band < numRows; band += bandRows) {
+        const int bandEnd = std::min(numRows, band + bandRows);
+        const Grid::Word* words = rowData(buffers[current], band);
+        for (std::size_t i = 0, n = static_cast<std::size_t>(bandEnd - band) * rowWords; i < n; ++i) {
+            count += std::bitset<Grid::kWordBits>(words[i]).count();
+        }
+        advise(buffers[current], band, bandEnd, MADV_DONTNEED);
+    }
+    return count;
+}
+
+bool MappedGrid::save(const std::string& filename, const std::string& name) {
+    if (endsWith(filename, ".snap")) {
+        Buffer& buffer = buffers[current];
+        writeHeader(buffer);
+        int output = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        bool ok = output >= 0 && copyFileRange(buffer.fd, 0, output, 0, buffer.length, nullptr);
+        if (output >= 0 && !ok) {
+            // Ядро не скопировало файл: пишем прямо из отображения
+            ok = ::lseek(output, 0, SEEK_SET) == 0 &&
+                 ::write(output, buffer.base, buffer.length) == static_cast<ssize_t>(buffer.length);
+        }
+        ok = output >= 0 && ::close(output) == 0 && ok;
+        if (!ok) {
+            std::cerr << "Error: Unable to write output file '" << filename << "'" << std::endl;
+        }
+        return ok;
+    }
+
+    FileWriter out(filename);
+    if (!out.isOpen()) {
+        std::cerr << "Error: Unable to open output file '" << filename << "'" << std::endl;
+        return false;
+    }
+    writeLife106Header(out, name, ruleMasks);
+    out.write("#S ");
+    out.writeInt(numRows);
+    out.put(' ');
+    out.writeInt(numCols);
+    out.put('\n');
+    for (int row = 0; row < numRows; ++row) {
+        const Grid::Word* words = rowData(buffers[current], row);
+        for (int word = 0; word < rowWords; ++word) {
+            for (Grid::Word bits = words[word]; bits != 0; bits &= bits - 1) {
+                out.writeInt(static_cast<std::int64_t>(word) * Grid::kWordBits + __builtin_ctzll(bits));
+                out.put(' ');
+                out.writeInt(row);
+                out.put('\n');
+            }
+        }
+    }
+    if (!out.close()) {
+        std::cerr << "Error: Unable to write output file '" << filename << "'" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void MappedGrid::copyToGrid(Grid& grid) const {
+    grid.clear();
+    for (int row = 0; row < std::min(numRows, grid.rows()); ++row) {
+        for (int col = 0; col < std::min(numCols, grid.cols()); ++col) {
+            if (get(row, col)) {
+                grid.set(row, col, true);
+            }
+        }
+    }
+}
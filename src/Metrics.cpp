@@ -0,0 +1,107 @@
+#include "include/Metrics.h"
+#include <iomanip>
+
+namespace {
+
+const char* const kPhaseNames[] = {"step", "render", "save", "load"};
+
+} // namespace
+
+Metrics& metrics() {
+    static Metrics instance;
+    return instance;
+}
+
+void Metrics::addTime(Phase phase, std::uint64_t nanoseconds) {
+    AtomicPhase& stats = phases[static_cast<std::size_t>(phase)];
+    stats.count.fetch_add(1, std::memory_order_relaxed);
+    stats.totalNanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+    std::uint64_t previous = stats.maxNanoseconds.load(std::memory_order_relaxed);
+    while (nanoseconds > previous &&
+           !stats.maxNanoseconds.compare_exchange_weak(previous, nanoseconds, std::memory_order_relaxed)) {
+    }
+}
+
+void Metrics::recordGeneration(const GenerationStats& stats) {
+    history[recorded % kHistory] = stats;
+    ++recorded;
+}
+
+Metrics::PhaseStats Metrics::phase(Phase phase) const {
+    const AtomicPhase& stats = phases[static_cast<std::size_t>(phase)];
+    return {stats.count.load(std::memory_order_relaxed), stats.totalNanoseconds.load(std::memory_order_relaxed),
+            stats.maxNanoseconds.load(std::memory_order_relaxed)};
+}
+
+double Metrics::cellsPerSecond() const {
+    std::uint64_t nanoseconds = phase(Phase::Step).totalNanoseconds;
+    return nanoseconds == 0 ? 0 : cellsStepped.load(std::memory_order_relaxed) * 1e9 / nanoseconds;
+}
+
+const GenerationStats& Metrics::generation(std::size_t index) const {
+    std::size_t first = recorded < kHistory ? 0 : recorded - kHistory;
+    return history[(first + index) % kHistory];
+}
+
+void Metrics::reset() {
+    for (AtomicPhase& stats : phases) {
+        stats.count = 0;
+        stats.totalNanoseconds = 0;
+        stats.maxNanoseconds = 0;
+    }
+    cellsStepped = 0;
+    allocations = 0;
+    recorded = 0;
+}
+
+void Metrics::writeSummary(std::ostream& out) const {
+#if !GOL_METRICS
+    out << "Metrics are disabled in this build (GOL_METRICS=0)\n";
+#endif
+    out << std::fixed << std::setprecision(3);
+    for (std::size_t i = 0; i < phases.size(); ++i) {
+        PhaseStats stats = phase(static_cast<Phase>(i));
+        out << "  " << std::left << std::setw(7) << kPhaseNames[i] << std::right << " count " << stats.count
+            << ", total " << stats.totalNanoseconds / 1e6 << " ms";
+        if (stats.count > 0) {
+            out << ", mean " << stats.totalNanoseconds / 1e3 / stats.count << " us, max "
+                << stats.maxNanoseconds / 1e3 << " us";
+        }
+        out << "\n";
+    }
+    out << std::scientific << std::setprecision(3) << "  cells/s " << cellsPerSecond() << "\n";
+    if (generationCount() > 0) {
+        const GenerationStats& last = generation(generationCount() - 1);
+        out << "  iteration " << last.iteration << ": population " << last.population << ", births "
+            << last.births << ", deaths " << last.deaths << "\n";
+    }
+    out << "  allocations " << allocationCount() << "\n";
+    out << std::defaultfloat;
+}
+
+void Metrics::writeJson(std::ostream& out) const {
+    out << "{\n  \"phases\": {";
+    for (std::size_t i = 0; i < phases.size(); ++i) {
+        PhaseStats stats = phase(static_cast<Phase>(i));
+        out << (i == 0 ? "\n" : ",\n") << "    \"" << kPhaseNames[i] << "\": {\"count\": " << stats.count
+            << ", \"total_ns\": " << stats.totalNanoseconds << ", \"max_ns\": " << stats.maxNanoseconds << "}";
+    }
+    out << "\n  },\n  \"cells_per_second\": " << cellsPerSecond() << ",\n  \"allocations\": " << allocationCount()
+        << ",\n  \"generations\": [";
+    for (std::size_t i = 0; i < generationCount(); ++i) {
+        const GenerationStats& stats = generation(i);
+        out << (i == 0 ? "\n" : ",\n") << "    {\"iteration\": " << stats.iteration << ", \"population\": "
+            << stats.population << ", \"births\": " << stats.births << ", \"deaths\": " << stats.deaths
+            << ", \"step_ns\": " << stats.stepNanoseconds << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+void Metrics::writeCsv(std::ostream& out) const {
+    out << "iteration,population,births,deaths,step_ns\n";
+    for (std::size_t i = 0; i < generationCount(); ++i) {
+        const GenerationStats& stats = generation(i);
+        out << stats.iteration << "," << stats.population << "," << stats.births << "," << stats.deaths << ","
+            << stats.stepNanoseconds << "\n";
+    }
+}
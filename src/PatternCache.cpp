@@ -0,0 +1,144 @@
+#include "include/PatternCache.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Имена файлов .txt каталога по алфавиту
+std::vector<std::string> listTextFiles(const std::string& directory, bool& found) {
+    std::vector<std::string> files;
+    found = fs::exists(directory) && fs::is_directory(directory);
+    if (found) {
+        for (const auto& entry : fs::directory_iterator(directory)) {
+            if (entry.is_regular_file() && entry.path().extension() == ".txt") {
+                files.push_back(entry.path().filename().string());
+            }
+        }
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+// OR count младших битов value в строку начиная со столбца col (col + count не выходит за строку)
+inline void orBits(Grid::Word* row, int col, Grid::Word value, int count) {
+    const int word = col / Grid::kWordBits;
+    const int shift = col % Grid::kWordBits;
+    row[word] |= value << shift;
+    if (shift != 0 && shift + count > Grid::kWordBits) {
+        row[word + 1] |= value >> (Grid::kWordBits - shift);
+    }
+}
+
+} // namespace
+
+PatternCache::PatternCache(std::string templatesDirectory, std::string rulesDirectory)
+    : templatesDir(std::move(templatesDirectory)), rulesDir(std::move(rulesDirectory)) {
+    names = listTextFiles(templatesDir, templatesDirFound);
+    for (const std::string& name : names) {
+        loadTemplate(name);
+    }
+
+    for (const std::string& file : listTextFiles(rulesDir, rulesDirFound)) {
+        std::ifstream input(rulesDir + "/" + file);
+        RuleEntry entry{file, std::string()};
+        std::getline(input, entry.text);
+        ruleTexts[file] = entry.text;
+        ruleEntries.push_back(std::move(entry));
+    }
+}
+
+const Grid* PatternCache::loadTemplate(const std::string& name) {
+    std::ifstream file(templatesDir + "/" + name);
+    if (!file.is_open()) {
+        return nullptr;
+    }
+    std::ostringstream text;
+    text << file.rdbuf();
+    return &(templates[name] = parseTemplate(text.str()));
+}
+
+const Grid* PatternCache::findTemplate(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = templates.find(name);
+    return found != templates.end() ? &found->second : loadTemplate(name);
+}
+
+bool PatternCache::findRule(const std::string& name, std::string& text) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = ruleTexts.find(name);
+    if (found == ruleTexts.end()) {
+        std::ifstream file(rulesDir + "/" + name);
+        if (!file.is_open()) {
+            return false;
+        }
+        std::string line;
+        std::getline(file, line);
+        found = ruleTexts.emplace(name, line).first;
+    }
+    text = found->second;
+    return true;
+}
+
+PatternCache& patternCache() {
+    static PatternCache cache("templates", "rules");
+    return cache;
+}
+
+Grid parseTemplate(const std::string& text) {
+    std::vector<std::string> lines;
+    std::istringstream input(text);
+    std::size_t width = 0;
+    for (std::string line; std::getline(input, line);) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        width = std::max(width, line.size());
+        lines.push_back(std::move(line));
+    }
+
+    Grid pattern(static_cast<int>(lines.size()), static_cast<int>(width));
+    for (std::size_t row = 0; row < lines.size(); ++row) {
+        for (std::size_t col = 0; col < lines[row].size(); ++col) {
+            if (lines[row][col] == 'O') {
+                pattern.set(static_cast<int>(row), static_cast<int>(col), true);
+            }
+        }
+    }
+    return pattern;
+}
+
+void blitPattern(Grid& grid, const Grid& pattern, int startRow, int startCol) {
+    const int numRows = grid.rows();
+    const int numCols = grid.cols();
+    if (numRows == 0 || numCols == 0) {
+        return;
+    }
+    const int firstRow = (startRow % numRows + numRows) % numRows;
+    const int firstCol = (startCol % numCols + numCols) % numCols;
+
+    for (int row = 0; row < pattern.rows(); ++row) {
+        const Grid::Word* source = pattern.rowData(row);
+        Grid::Word* target = grid.rowData((firstRow + row) % numRows);
+        for (int word = 0; word < pattern.wordsPerRow(); ++word) {
+            Grid::Word value = source[word];
+            if (value == 0) {
+                continue;
+            }
+            // Часть слова, которая не помещается до правого края, переносится в начало строки
+            int bits = std::min(Grid::kWordBits, pattern.cols() - word * Grid::kWordBits);
+            int col = static_cast<int>((static_cast<long long>(firstCol) + word * Grid::kWordBits) % numCols);
+            while (bits > 0) {
+                int count = std::min(bits, numCols - col);
+                Grid::Word part = count == Grid::kWordBits ? value : value & ((Grid::Word(1) << count) - 1);
+                orBits(target, col, part, count);
+                value = count == Grid::kWordBits ? 0 : value >> count;
+                bits -= count;
+                col = 0;
+            }
+        }
+    }
+}
@@ -0,0 +1,287 @@
+#include "include/RangeRule.h"
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+
+namespace {
+
+// Высота полосы строк для ромба фон Неймана. Таблицы префиксных сумм строятся на полосу
+// с запасом R строк сверху и снизу, поэтому полоса берется не ниже 4R, чтобы запас не перевешивал расчет
+constexpr int kVonNeumannBandRows = 64;
+
+int wrap(long long value, int size) {
+    value %= size;
+    return static_cast<int>(value < 0 ? value + size : value);
+}
+
+// Неотрицательное число во всей строке text
+bool parseCount(const std::string& text, int& value) {
+    if (text.empty() || text.size() > 9 || !std::all_of(text.begin(), text.end(), ::isdigit)) {
+        return false;
+    }
+    value = std::atoi(text.c_str());
+    return true;
+}
+
+// Диапазон "min..max" или одно число
+bool parseRange(const std::string& text, int& low, int& high) {
+    std::size_t dots = text.find("..");
+    if (dots == std::string::npos) {
+        return parseCount(text, low) && parseCount(text, high);
+    }
+    return parseCount(text.substr(0, dots), low) && parseCount(text.substr(dots + 2), high);
+}
+
+// Добавить живые клетки строки row к суммам по столбцам (delta = 1) или вычесть их (delta = -1)
+void addRow(const Grid& grid, int row, std::uint32_t* columns, std::uint32_t delta) {
+    const Grid::Word* words = grid.rowData(row);
+    for (int word = 0; word < grid.wordsPerRow(); ++word) {
+        for (Grid::Word bits = words[word]; bits != 0; bits &= bits - 1) {
+            columns[word * Grid::kWordBits + __builtin_ctzll(bits)] += delta;
+        }
+    }
+}
+
+inline bool nextState(const RangeRule& rule, bool alive, std::uint32_t count) {
+    return alive ? count >= static_cast<std::uint32_t>(rule.surviveMin) &&
+                       count <= static_cast<std::uint32_t>(rule.surviveMax)
+                 : count >= static_cast<std::uint32_t>(rule.birthMin) &&
+                       count <= static_cast<std::uint32_t>(rule.birthMax);
+}
+
+// Квадрат Мура для строк [rowBegin, rowEnd). Суммы по столбцам окна строк row - R .. row + R
+// сдвигаются на строку добавлением входящей строки и вычитанием уходящей, окно по строке —
+// на столбец добавлением входящего столбца и вычитанием уходящего
+void stepMoore(const Grid& current, Grid::Word* next, const RangeRule& rule, int rowBegin, int rowEnd,
+               std::vector<std::uint32_t>& columns) {
+    const int rows = current.rows();
+    const int cols = current.cols();
+    const int words = current.wordsPerRow();
+    const int range = rule.range;
+
+    columns.assign(cols, 0);
+    for (int dr = -range; dr <= range; ++dr) {
+        addRow(current, wrap(rowBegin + dr, rows), columns.data(), 1);
+    }
+
+    for (int row = rowBegin; row < rowEnd; ++row) {
+        std::uint32_t window = 0;
+        for (int dc = -range; dc <= range; ++dc) {
+            window += columns[wrap(dc, cols)];
+        }
+        int enter = wrap(range + 1, cols);
+        int leave = wrap(-range, cols);
+
+        const Grid::Word* mid = current.rowData(row);
+        Grid::Word* out = next + static_cast<std::size_t>(row) * words;
+        for (int word = 0; word < words; ++word) {
+            const int bits = std::min(Grid::kWordBits, cols - word * Grid::kWordBits);
+            Grid::Word result = 0;
+            for (int bit = 0; bit < bits; ++bit) {
+                const bool alive = (mid[word] >> bit) & 1u;
+                const std::uint32_t count = window - (rule.countCenter ? 0u : alive);
+                result |= static_cast<Grid::Word>(nextState(rule, alive, count)) << bit;
+                window += columns[enter] - columns[leave];
+                enter = enter + 1 == cols ? 0 : enter + 1;
+                leave = leave + 1 == cols ? 0 : leave + 1;
+            }
+            out[word] = result;
+        }
+
+        if (row + 1 < rowEnd) {
+            addRow(current, wrap(row + 1 + range, rows), columns.data(), 1);
+            addRow(current, wrap(row - range, rows), columns.data(), static_cast<std::uint32_t>(-1));
+        }
+    }
+}
+
+// Ромб фон Неймана для строк [rowBegin, rowEnd). Таблицы строятся на полосу с запасом R строк
+// и R столбцов с каждой стороны (клетки за краями берутся с противоположного края тора):
+// diagonal[i][j] — сумма клеток от (i, j) вверх-влево по диагонали, antiDiagonal[i][j] — вверх-вправо.
+// При сдвиге ромба на столбец вправо входит его правая граница, а выходит левая граница
+// предыдущего ромба; каждая граница — два диагональных отрезка, сумма отрезка — разность двух элементов таблицы
+void stepVonNeumann(const Grid& current, Grid::Word* next, const RangeRule& rule, int rowBegin, int rowEnd,
+                    std::vector<std::uint32_t>& diagonal, std::vector<std::uint32_t>& antiDiagonal) {
+    const int rows = current.rows();
+    const int cols = current.cols();
+    const int words = current.wordsPerRow();
+    const int range = rule.range;
+    const int height = rowEnd - rowBegin + 2 * range;
+    const int width = cols + 2 * range;
+
+    diagonal.resize(static_cast<std::size_t>(height) * width);
+    antiDiagonal.resize(static_cast<std::size_t>(height) * width);
+    for (int i = 0; i < height; ++i) {
+        const Grid::Word* source = current.rowData(wrap(rowBegin - range + i, rows));
+        std::uint32_t* diag = diagonal.data() + static_cast<std::size_t>(i) * width;
+        std::uint32_t* anti = antiDiagonal.data() + static_cast<std::size_t>(i) * width;
+        int col = wrap(-range, cols);
+        for (int j = 0; j < width; ++j) {
+            const std::uint32_t cell = (source[col / Grid::kWordBits] >> (col % Grid::kWordBits)) & 1u;
+            diag[j] = cell + (i > 0 && j > 0 ? diag[j - 1 - width] : 0);
+            anti[j] = cell + (i > 0 && j + 1 < width ? anti[j + 1 - width] : 0);
+            col = col + 1 == cols ? 0 : col + 1;
+        }
+    }
+
+    // Сумма отрезка от (i1, j1) до строки i2 вниз-вправо и вниз-влево
+    auto diagonalSum = [&](int i1, int j1, int i2) {
+        const std::uint32_t end = diagonal[static_cast<std::size_t>(i2) * width + j1 + (i2 - i1)];
+        return end - (i1 > 0 && j1 > 0 ? diagonal[static_cast<std::size_t>(i1 - 1) * width + j1 - 1] : 0);
+    };
+    auto antiDiagonalSum = [&](int i1, int j1, int i2) {
+        const std::uint32_t end = antiDiagonal[static_cast<std::size_t>(i2) * width + j1 - (i2 - i1)];
+        return end - (i1 > 0 && j1 + 1 < width ? antiDiagonal[static_cast<std::size_t>(i1 - 1) * width + j1 + 1] : 0);
+    };
+
+    for (int row = rowBegin; row < rowEnd; ++row) {
+        const int pi = row - rowBegin + range; // Строка центра в таблицах
+
+        // Ромб вокруг первой клетки строки считается напрямую
+        std::uint32_t count = 0;
+        for (int dr = -range; dr <= range; ++dr) {
+            const int span = range - std::abs(dr);
+            for (int dc = -span; dc <= span; ++dc) {
+                count += current.get(wrap(row + dr, rows), wrap(dc, cols));
+            }
+        }
+
+        const Grid::Word* mid = current.rowData(row);
+        Grid::Word* out = next + static_cast<std::size_t>(row) * words;
+        std::fill(out, out + words, Grid::Word(0));
+        for (int col = 0; col < cols; ++col) {
+            if (col > 0) {
+                const int pj = col + range; // Столбец центра в таблицах
+                count += diagonalSum(pi - range, pj, pi) + antiDiagonalSum(pi + 1, pj + range - 1, pi + range);
+                count -= antiDiagonalSum(pi - range, pj - 1, pi) + diagonalSum(pi + 1, pj - range, pi + range);
+            }
+            const bool alive = (mid[col / Grid::kWordBits] >> (col % Grid::kWordBits)) & 1u;
+            if (nextState(rule, alive, count - (rule.countCenter ? 0u : alive))) {
+                out[col / Grid::kWordBits] |= Grid::Word(1) << (col % Grid::kWordBits);
+            }
+        }
+    }
+}
+
+} // namespace
+
+int RangeRule::cellCount() const {
+    const int cells = neighborhood == Neighborhood::Moore ? (2 * range + 1) * (2 * range + 1)
+                                                          : 2 * range * (range + 1) + 1;
+    return countCenter ? cells : cells - 1;
+}
+
+bool RangeRule::operator==(const RangeRule& other) const {
+    return range == other.range && countCenter == other.countCenter && neighborhood == other.neighborhood &&
+           surviveMin == other.surviveMin && surviveMax == other.surviveMax && birthMin == other.birthMin &&
+           birthMax == other.birthMax;
+}
+
+bool parseRangeRule(const std::string& text, RangeRule& rule) {
+    RangeRule parsed;
+    bool survival = false;
+    bool birth = false;
+    std::istringstream input(text);
+    for (std::string token; std::getline(input, token, ',');) {
+        token.erase(std::remove_if(token.begin(), token.end(), ::isspace), token.end());
+        if (token.empty()) {
+            return false;
+        }
+        const std::string value = token.substr(1);
+        int number = 0;
+        switch (std::toupper(static_cast<unsigned char>(token[0]))) {
+            case 'R':
+                if (!parseCount(value, parsed.range)) {
+                    return false;
+                }
+                break;
+            case 'C': // Несколько состояний (правила Generations) не поддерживаются
+                if (!parseCount(value, number) || (number != 0 && number != 2)) {
+                    return false;
+                }
+                break;
+            case 'M':
+                if (!parseCount(value, number) || number > 1) {
+                    return false;
+                }
+                parsed.countCenter = number == 1;
+                break;
+            case 'S':
+                survival = parseRange(value, parsed.surviveMin, parsed.surviveMax);
+                if (!survival) {
+                    return false;
+                }
+                break;
+            case 'B':
+                birth = parseRange(value, parsed.birthMin, parsed.birthMax);
+                if (!birth) {
+                    return false;
+                }
+                break;
+            case 'N':
+                if (value == "M" || value == "m") {
+                    parsed.neighborhood = RangeRule::Neighborhood::Moore;
+                } else if (value == "N" || value == "n") {
+                    parsed.neighborhood = RangeRule::Neighborhood::VonNeumann;
+                } else {
+                    return false;
+                }
+                break;
+            default:
+                return false;
+        }
+    }
+
+    if (parsed.range < 1 || parsed.range > RangeRule::kMaxRange || !survival || !birth ||
+        parsed.surviveMin > parsed.surviveMax || parsed.birthMin > parsed.birthMax ||
+        parsed.surviveMax > parsed.cellCount() || parsed.birthMax > parsed.cellCount()) {
+        return false;
+    }
+    rule = parsed;
+    return true;
+}
+
+std::string formatRangeRule(const RangeRule& rule) {
+    std::ostringstream out;
+    out << 'R' << rule.range << ",C0,M" << (rule.countCenter ? 1 : 0) << ",S" << rule.surviveMin << ".."
+        << rule.surviveMax << ",B" << rule.birthMin << ".." << rule.birthMax << ",N"
+        << (rule.neighborhood == RangeRule::Neighborhood::Moore ? 'M' : 'N');
+    return out.str();
+}
+
+void RangeKernel::step(const Grid& current, Grid& next, const RangeRule& rule, ThreadPool* pool) {
+    if (next.rows() != current.rows() || next.cols() != current.cols()) {
+        next.resize(current.rows(), current.cols());
+    }
+    const int rows = current.rows();
+    if (rows == 0 || current.cols() == 0) {
+        return;
+    }
+    Grid::Word* out = next.data();
+
+    // Каждый поток считает свою полосу строк. Для квадрата Мура суммы по столбцам сдвигаются
+    // по всей полосе потока, для ромба полоса делится на части высотой не меньше 4R
+    const int stripes = pool ? std::min(pool->size(), rows) : 1;
+    if (scratch.size() < static_cast<std::size_t>(stripes)) {
+        scratch.resize(stripes);
+    }
+    const int bandRows = std::max(kVonNeumannBandRows, 4 * rule.range);
+    auto stepStripe = [&](int stripe) {
+        const int rowBegin = rows * stripe / stripes;
+        const int rowEnd = rows * (stripe + 1) / stripes;
+        Scratch& buffers = scratch[stripe];
+        if (rule.neighborhood == RangeRule::Neighborhood::Moore) {
+            stepMoore(current, out, rule, rowBegin, rowEnd, buffers.columns);
+        } else {
+            for (int band = rowBegin; band < rowEnd; band += bandRows) {
+                stepVonNeumann(current, out, rule, band, std::min(rowEnd, band + bandRows), buffers.diagonal,
+                               buffers.antiDiagonal);
+            }
+        }
+    };
+    if (pool && stripes > 1) {
+        pool->parallelFor(stripes, stepStripe);
+    } else {
+        stepStripe(0);
+    }
+}
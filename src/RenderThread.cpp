@@ -0,0 +1,51 @@
+#include "include/RenderThread.h"
+#include <chrono>
+
+RenderThread::RenderThread(TerminalRenderer& renderer, std::ostream& out)
+    : renderer(renderer), out(out), thread([this] { run(); }) {}
+
+RenderThread::~RenderThread() {
+    finish();
+}
+
+bool RenderThread::publish(const Game& game, bool force) {
+    if (!force && !wantFrame.exchange(false, std::memory_order_acq_rel)) {
+        return false;
+    }
+    // Слот писателя переиспользуется: при неизменном размере поля копирование не выделяет память
+    RenderFrame& frame = frames.writeSlot();
+    frame.field = game.field;
+    frame.header.clear();
+    TerminalRenderer::appendHeader(game, frame.header);
+    frames.publish();
+    ++published;
+    return true;
+}
+
+void RenderThread::finish() {
+    if (thread.joinable()) {
+        stopping.store(true, std::memory_order_release);
+        thread.join();
+    }
+}
+
+void RenderThread::run() {
+    while (true) {
+        // Признак остановки читается до проверки буфера: все, что опубликовано до него, будет показано
+        bool stop = stopping.load(std::memory_order_acquire);
+        if (frames.consume()) {
+            const RenderFrame& frame = frames.readSlot();
+            renderer.draw(frame.field, frame.header, out);
+            shown.fetch_add(1, std::memory_order_relaxed);
+            if (stop) {
+                break;
+            }
+            renderer.waitForNextFrame();
+            wantFrame.store(true, std::memory_order_release);
+        } else if (stop) {
+            break;
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
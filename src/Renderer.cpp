@@ -0,0 +1,202 @@
+#include "include/Renderer.h"
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+namespace {
+
+constexpr int kHeaderLines = 4; // #Life, #N, #R и номер итерации
+
+bool cellAt(const Grid& grid, int row, int col) {
+    if (row >= grid.rows() || col >= grid.cols()) {
+        return false;
+    }
+    return (grid.rowData(row)[col / Grid::kWordBits] >> (col % Grid::kWordBits)) & 1u;
+}
+
+// Символ Юникода из диапазона U+0800..U+FFFF в UTF-8
+void appendUtf8(std::string& out, unsigned codePoint) {
+    out += static_cast<char>(0xE0 | (codePoint >> 12));
+    out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+    out += static_cast<char>(0x80 | (codePoint & 0x3F));
+}
+
+// Перевести курсор в начало строки экрана line (нумерация с 1)
+void appendMoveTo(std::string& out, int line) {
+    out += "\x1b[";
+    out += std::to_string(line);
+    out += ";1H";
+}
+
+} // namespace
+
+void TerminalRenderer::setGlyphs(Glyphs newGlyphs) {
+    glyphs = newGlyphs;
+    fullRedraw = true;
+}
+
+bool TerminalRenderer::parseGlyphs(const std::string& name, Glyphs& result) {
+    if (name == "ascii") {
+        result = Glyphs::Ascii;
+    } else if (name == "half") {
+        result = Glyphs::HalfBlock;
+    } else if (name == "braille") {
+        result = Glyphs::Braille;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void TerminalRenderer::appendHeader(const Game& game, std::string& out) {
+    appendHeader(game, game.curIteration, out);
+}
+
+void TerminalRenderer::appendHeader(const Game& game, long long iteration, std::string& out) {
+    out += "#Life v1.0\n#N ";
+    out += game.gameName;
+    out += "\n#R ";
+    out += game.ruleString();
+    out += '\n';
+    out += std::to_string(iteration);
+    out += '\n';
+}
+
+void TerminalRenderer::appendFieldLine(const Grid& grid, int line, int width) {
+    const int row = line * rowsPerLine();
+    frame += "│";
+    for (int i = 0; i < width; ++i) {
+        switch (glyphs) {
+            case Glyphs::Ascii:
+                frame += cellAt(grid, row, i) ? 'X' : ' ';
+                break;
+            case Glyphs::HalfBlock: {
+                bool top = cellAt(grid, row, i);
+                bool bottom = cellAt(grid, row + 1, i);
+                if (top || bottom) {
+                    appendUtf8(frame, top && bottom ? 0x2588 : top ? 0x2580 : 0x2584); // █ ▀ ▄
+                } else {
+                    frame += ' ';
+                }
+                break;
+            }
+            case Glyphs::Braille: {
+                // Номера точек Брайля: 1-3 и 7 в левом столбце, 4-6 и 8 в правом
+                static const unsigned kDots[4][2] = {{0x01, 0x08}, {0x02, 0x10}, {0x04, 0x20}, {0x40, 0x80}};
+                unsigned dots = 0;
+                for (int dy = 0; dy < 4; ++dy) {
+                    for (int dx = 0; dx < 2; ++dx) {
+                        if (cellAt(grid, row + dy, 2 * i + dx)) {
+                            dots |= kDots[dy][dx];
+                        }
+                    }
+                }
+                appendUtf8(frame, 0x2800 + dots);
+                break;
+            }
+        }
+    }
+    frame += "│";
+}
+
+const std::string& TerminalRenderer::renderFrame(const Game& game) {
+    header.clear();
+    appendHeader(game, header);
+    return renderGrid(game.field);
+}
+
+const std::string& TerminalRenderer::renderFrame(const Grid& grid, const std::string& frameHeader) {
+    header.assign(frameHeader);
+    return renderGrid(grid);
+}
+
+const std::string& TerminalRenderer::renderGrid(const Grid& grid) {
+    const int width = (grid.cols() + cellsPerLine() - 1) / cellsPerLine();
+    const int lines = (grid.rows() + rowsPerLine() - 1) / rowsPerLine();
+
+    frame.clear();
+    lastRedrawnRows = 0;
+
+    if (grid.rows() != shown.rows() || grid.cols() != shown.cols()) {
+        fullRedraw = true;
+    }
+
+    if (fullRedraw) {
+        frame += "\x1b[H\x1b[2J";
+        frame += header;
+        frame += "┌";
+        frame.append(width, '-');
+        frame += "┐\n";
+        for (int line = 0; line < lines; ++line) {
+            appendFieldLine(grid, line, width);
+            frame += '\n';
+        }
+        frame += "└";
+        frame.append(width, '-');
+        frame += "┘\n";
+        lastRedrawnRows = lines;
+    } else {
+        if (header != previousHeader) {
+            appendMoveTo(frame, 1);
+            // Строки заголовка стираются до конца, так как новый текст может быть короче
+            for (std::size_t begin = 0; begin < header.size();) {
+                std::size_t end = header.find('\n', begin);
+                frame.append(header, begin, end - begin);
+                frame += "\x1b[K\n";
+                begin = end + 1;
+            }
+        }
+
+        // Строка экрана перерисовывается, если изменилось хотя бы одно слово ее строк поля
+        const std::size_t rowBytes = static_cast<std::size_t>(grid.wordsPerRow()) * sizeof(Grid::Word);
+        for (int line = 0; line < lines; ++line) {
+            int rowBegin = line * rowsPerLine();
+            int rowEnd = std::min(rowBegin + rowsPerLine(), grid.rows());
+            bool changed = false;
+            for (int row = rowBegin; row < rowEnd && !changed; ++row) {
+                changed = std::memcmp(grid.rowData(row), shown.rowData(row), rowBytes) != 0;
+            }
+            if (changed) {
+                appendMoveTo(frame, kHeaderLines + 2 + line);
+                appendFieldLine(grid, line, width);
+                ++lastRedrawnRows;
+            }
+        }
+        // Курсор возвращается под рамку, где его оставил полный кадр
+        appendMoveTo(frame, kHeaderLines + 3 + lines);
+    }
+
+    fullRedraw = false;
+    shown = grid;
+    previousHeader.swap(header);
+    return frame;
+}
+
+void TerminalRenderer::draw(const Game& game, std::ostream& out) {
+    GOL_SCOPED_TIMER(Phase::Render);
+    const std::string& text = renderFrame(game);
+    out.write(text.data(), static_cast<std::streamsize>(text.size()));
+    out.flush();
+}
+
+void TerminalRenderer::draw(const Grid& grid, const std::string& frameHeader, std::ostream& out) {
+    GOL_SCOPED_TIMER(Phase::Render);
+    const std::string& text = renderFrame(grid, frameHeader);
+    out.write(text.data(), static_cast<std::streamsize>(text.size()));
+    out.flush();
+}
+
+void TerminalRenderer::waitForNextFrame() {
+    if (maxFps <= 0) {
+        return;
+    }
+    auto interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(1.0 / maxFps));
+    auto now = std::chrono::steady_clock::now();
+    // После долгой паузы (например, ожидания команды) отсчет начинается заново, без серии кадров подряд
+    if (nextFrameTime + interval < now) {
+        nextFrameTime = now;
+    }
+    nextFrameTime += interval;
+    std::this_thread::sleep_until(nextFrameTime);
+}
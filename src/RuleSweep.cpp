@@ -0,0 +1,175 @@
+#include "include/RuleSweep.h"
+#include "include/CycleDetector.h"
+#include "include/LifeFile.h"
+#include "include/PatternCache.h"
+#include "include/ThreadPool.h"
+#include <algorithm>
+#include <iomanip>
+#include <random>
+#include <sstream>
+
+namespace {
+
+constexpr std::size_t kRunsPerTask = 64; // Прогонов в одной задаче потока: поля и история используются повторно
+
+// Один шаг маленького поля: строки замыкаются по вертикали здесь, по горизонтали — в ядре
+void stepBoard(const Grid& current, Grid& next, RowKernel kernel, const RuleMasks& rule) {
+    const int rows = current.rows();
+    for (int row = 0; row < rows; ++row) {
+        kernel(current.rowData(row == 0 ? rows - 1 : row - 1), current.rowData(row),
+               current.rowData(row + 1 == rows ? 0 : row + 1), next.rowData(row), current.cols(), 0,
+               current.wordsPerRow(), rule);
+    }
+}
+
+void runBoard(SweepRun& run, const SweepOptions& options, Grid& current, Grid& next, CycleDetector& cycles) {
+    const RowKernel kernel = activeKernel().select(run.rule);
+    fillSoup(current, run.seed, options.density);
+    cycles.clear();
+    cycles.record(gridHash(current), 0);
+
+    long long generation = 0;
+    while (generation < options.generations) {
+        stepBoard(current, next, kernel, run.rule);
+        current.swap(next);
+        ++generation;
+
+        // При B0 пустое поле на следующем шаге заполняется целиком: это не вымирание,
+        // период (пусто — полно) найдет поиск циклов
+        if (run.extinction < 0 && !(run.rule.birth & 1u) && current.population() == 0) {
+            run.extinction = generation;
+            run.period = 1;
+            run.cycleStart = generation;
+            break;
+        }
+        if (run.period == 0 && cycles.record(gridHash(current), generation)) {
+            run.period = cycles.period();
+            run.cycleStart = cycles.cycleStart();
+            // Полные периоды до предела ничего не меняют: досчитывается только остаток
+            long long remaining = options.generations - generation;
+            generation = options.generations - remaining % run.period;
+        }
+    }
+    run.population = current.population();
+}
+
+} // namespace
+
+bool sweepRules(const std::string& spec, std::vector<RuleMasks>& rules, std::ostream& errors) {
+    rules.clear();
+    if (spec == "all") {
+        for (unsigned birth = 0; birth < 512; ++birth) {
+            for (unsigned survival = 0; survival < 512; ++survival) {
+                rules.push_back({static_cast<std::uint16_t>(birth), static_cast<std::uint16_t>(survival)});
+            }
+        }
+        return true;
+    }
+
+    if (spec == "rules") {
+        // Правила берутся из общего кэша каталога rules/, как у loadrules и randomrules
+        PatternCache& cache = patternCache();
+        if (!cache.rulesFound()) {
+            errors << "Error: Rules directory not found!" << std::endl;
+            return false;
+        }
+        for (const PatternCache::RuleEntry& entry : cache.rules()) {
+            RuleMasks rule;
+            // Пустые файлы и правила не вида B/S (например, Larger than Life) пропускаются
+            if (!parseRuleMasks(entry.text, rule)) {
+                errors << "Warning: No B/S rule in 'rules/" << entry.file << "', skipped" << std::endl;
+                continue;
+            }
+            rules.push_back(rule);
+        }
+        if (rules.empty()) {
+            errors << "Error: No rules files found in the rules directory!" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    std::istringstream list(spec);
+    std::string text;
+    while (std::getline(list, text, ',')) {
+        RuleMasks rule;
+        if (!parseRuleMasks(text, rule)) {
+            errors << "Error: Invalid rule '" << text << "'" << std::endl;
+            return false;
+        }
+        rules.push_back(rule);
+    }
+    if (rules.empty()) {
+        errors << "Error: Empty rule list" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void fillSoup(Grid& grid, unsigned seed, double density) {
+    std::mt19937 gen(seed);
+    std::bernoulli_distribution alive(density);
+    grid.clear();
+    for (int row = 0; row < grid.rows(); ++row) {
+        for (int col = 0; col < grid.cols(); ++col) {
+            if (alive(gen)) {
+                grid.set(row, col, true);
+            }
+        }
+    }
+}
+
+std::vector<SweepRun> runSweep(const std::vector<RuleMasks>& rules, const std::vector<unsigned>& seeds,
+                               const SweepOptions& options, int threads) {
+    std::vector<SweepRun> runs(rules.size() * seeds.size());
+    for (std::size_t i = 0; i < runs.size(); ++i) {
+        runs[i].rule = rules[i / seeds.size()];
+        runs[i].seed = seeds[i % seeds.size()];
+    }
+
+    // История циклов не длиннее самого прогона: очистка между прогонами остается дешевой
+    const std::size_t historySize =
+        static_cast<std::size_t>(std::min<long long>(std::max<long long>(options.generations + 1, 16), 4096));
+    const int tasks = static_cast<int>((runs.size() + kRunsPerTask - 1) / kRunsPerTask);
+    auto runTask = [&](int task) {
+        Grid current(options.rows, options.cols);
+        Grid next(options.rows, options.cols);
+        CycleDetector cycles(historySize);
+        std::size_t end = std::min(runs.size(), (task + 1) * kRunsPerTask);
+        for (std::size_t i = task * kRunsPerTask; i < end; ++i) {
+            runBoard(runs[i], options, current, next, cycles);
+        }
+    };
+
+    if (threads > 1 && tasks > 1) {
+        ThreadPool pool(std::min(threads, tasks));
+        pool.parallelFor(tasks, runTask);
+    } else {
+        for (int task = 0; task < tasks; ++task) {
+            runTask(task);
+        }
+    }
+    return runs;
+}
+
+void writeSweepTable(const std::vector<SweepRun>& runs, std::ostream& out) {
+    out << std::left << std::setw(24) << "rule" << std::right << std::setw(10) << "seed" << std::setw(12)
+        << "population" << std::setw(8) << "period" << std::setw(12) << "cycle_start" << std::setw(12)
+        << "extinction" << "\n";
+    for (const SweepRun& run : runs) {
+        out << std::left << std::setw(24) << formatRule(run.rule) << std::right << std::setw(10) << run.seed
+            << std::setw(12) << run.population << std::setw(8);
+        if (run.period > 0) {
+            out << run.period << std::setw(12) << run.cycleStart;
+        } else {
+            out << "-" << std::setw(12) << "-";
+        }
+        out << std::setw(12);
+        if (run.extinction >= 0) {
+            out << run.extinction;
+        } else {
+            out << "-";
+        }
+        out << "\n";
+    }
+}
@@ -0,0 +1,167 @@
+#include "include/SimulationWorker.h"
+
+SimulationWorker::SimulationWorker(Game& game, std::function<void(Game&)> afterGeneration)
+    : game(game), afterGeneration(std::move(afterGeneration)), generation(game.curIteration),
+      thread([this] { loop(); }) {}
+
+SimulationWorker::~SimulationWorker() {
+    stop();
+}
+
+std::uint64_t SimulationWorker::enqueue(Command command) {
+    std::lock_guard<std::mutex> lock(mutex);
+    command.id = ++issued;
+    commands.push_back(std::move(command));
+    wake.notify_one();
+    return issued;
+}
+
+void SimulationWorker::waitFor(std::uint64_t id) {
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [&] { return completed >= id || stopped; });
+}
+
+void SimulationWorker::run() {
+    enqueue(Command(Command::Kind::Run));
+}
+
+void SimulationWorker::step(long long generations) {
+    if (generations > 0) {
+        enqueue(Command(Command::Kind::Step, generations));
+    }
+}
+
+void SimulationWorker::pause() {
+    waitFor(enqueue(Command(Command::Kind::Pause)));
+}
+
+void SimulationWorker::call(std::function<void(Game&)> action) {
+    waitFor(enqueue(Command(Command::Kind::Call, 0, std::move(action))));
+}
+
+void SimulationWorker::waitIdle() {
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [&] { return (commands.empty() && !busy()) || stopped; });
+}
+
+const SimulationSnapshot& SimulationWorker::snapshot() {
+    std::unique_lock<std::mutex> lock(mutex);
+    snapshotRequested = true;
+    done.wait(lock, [&] { return !snapshotRequested || (!working && !busy()); });
+    if (snapshotRequested) {
+        // Расчет стоит, а пока командный цикл держит блокировку, он и не начнется:
+        // поле копирует сам командный цикл, поток расчета ничего не ждет
+        snapshotRequested = false;
+        SimulationSnapshot& slot = snapshots.writeSlot();
+        slot.field = game.field;
+        slot.generation = game.curIteration;
+        snapshots.publish();
+    }
+    snapshots.consume();
+    return snapshots.readSlot();
+}
+
+SimulationWorker::Status SimulationWorker::status() {
+    std::lock_guard<std::mutex> lock(mutex);
+    Status status;
+    status.generation = generation;
+    status.running = running;
+    status.pendingSteps = pendingSteps;
+    status.generationsPerSecond = lastRate;
+    if (wasBusy) {
+        double seconds = std::chrono::duration<double>(Clock::now() - startTime).count();
+        status.generationsPerSecond = seconds > 0 ? (generation - startGeneration) / seconds : 0;
+    }
+    return status;
+}
+
+void SimulationWorker::stop() {
+    if (thread.joinable()) {
+        enqueue(Command(Command::Kind::Stop));
+        thread.join();
+    }
+}
+
+void SimulationWorker::loop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        // Команды выполняются между поколениями; call отпускает блокировку, чтобы командный цикл
+        // мог ставить новые команды, но сам ждет его завершения
+        while (!commands.empty() && !stopped) {
+            Command command = std::move(commands.front());
+            commands.pop_front();
+            switch (command.kind) {
+                case Command::Kind::Run:
+                    running = true;
+                    break;
+                case Command::Kind::Step:
+                    pendingSteps += command.steps;
+                    break;
+                case Command::Kind::Pause:
+                    running = false;
+                    pendingSteps = 0;
+                    break;
+                case Command::Kind::Call:
+                    working = true;
+                    lock.unlock();
+                    command.action(game);
+                    lock.lock();
+                    working = false;
+                    generation = game.curIteration;
+                    break;
+                case Command::Kind::Stop:
+                    running = false;
+                    pendingSteps = 0;
+                    stopped = true;
+                    break;
+            }
+            completed = command.id;
+            done.notify_all();
+        }
+
+        const bool nowBusy = busy();
+        if (nowBusy != wasBusy) {
+            if (nowBusy) {
+                startTime = Clock::now();
+                startGeneration = generation;
+            } else {
+                double seconds = std::chrono::duration<double>(Clock::now() - startTime).count();
+                lastRate = seconds > 0 ? (generation - startGeneration) / seconds : 0;
+                done.notify_all();
+            }
+            wasBusy = nowBusy;
+        }
+        if (stopped) {
+            done.notify_all();
+            return;
+        }
+        if (!nowBusy) {
+            wake.wait(lock, [&] { return !commands.empty(); });
+            continue;
+        }
+
+        working = true;
+        lock.unlock();
+        game.calculateNextState();
+        if (afterGeneration) {
+            afterGeneration(game);
+        }
+        lock.lock();
+        working = false;
+        generation = game.curIteration;
+        if (pendingSteps > 0) {
+            --pendingSteps;
+        }
+
+        // Снимок — только что вытесненное прошлое поколение: его буфер меняется местами со слотом
+        // писателя, поле не копируется и расчет не задерживается
+        if (snapshotRequested) {
+            SimulationSnapshot& slot = snapshots.writeSlot();
+            game.exchangePreviousGeneration(slot.field);
+            slot.generation = game.curIteration - 1;
+            snapshots.publish();
+            snapshotRequested = false;
+            done.notify_all();
+        }
+    }
+}
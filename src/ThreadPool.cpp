@@ -0,0 +1,87 @@
+#include "include/ThreadPool.h"
+
+ThreadPool::ThreadPool(int threads) {
+    for (int i = 1; i < threads; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        stopping = true;
+    }
+    wakeWorkers.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::run(int tasks, TaskFunction function, void* context) {
+    if (tasks <= 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> runLock(runMutex);
+    if (workers.empty() || tasks == 1) {
+        for (int i = 0; i < tasks; ++i) {
+            function(context, i);
+        }
+        return;
+    }
+
+    {
+        // Опоздавший поток мог проснуться уже после прошлого задания — дожидаемся его
+        std::unique_lock<std::mutex> lock(stateMutex);
+        allDone.wait(lock, [this] { return activeWorkers == 0; });
+        currentFunction = function;
+        currentContext = context;
+        taskCount = tasks;
+        nextTask.store(0, std::memory_order_relaxed);
+        pendingTasks.store(tasks, std::memory_order_relaxed);
+        ++epoch;
+    }
+    wakeWorkers.notify_all();
+
+    // Вызывающий поток тоже разбирает задачи
+    drainTasks();
+
+    // Ждем не только завершения задач, но и выхода всех потоков из drainTasks,
+    // чтобы следующий вызов мог безопасно переписать состояние задания
+    std::unique_lock<std::mutex> lock(stateMutex);
+    allDone.wait(lock, [this] { return pendingTasks.load(std::memory_order_acquire) == 0 && activeWorkers == 0; });
+}
+
+void ThreadPool::drainTasks() {
+    int finished = 0;
+    for (int index = nextTask.fetch_add(1, std::memory_order_relaxed); index < taskCount;
+         index = nextTask.fetch_add(1, std::memory_order_relaxed)) {
+        currentFunction(currentContext, index);
+        ++finished;
+    }
+
+    if (finished > 0) {
+        pendingTasks.fetch_sub(finished, std::memory_order_acq_rel);
+    }
+}
+
+void ThreadPool::workerLoop() {
+    unsigned long long seenEpoch = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(stateMutex);
+            wakeWorkers.wait(lock, [&] { return stopping || epoch != seenEpoch; });
+            if (stopping) {
+                return;
+            }
+            seenEpoch = epoch;
+            ++activeWorkers;
+        }
+        drainTasks();
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            --activeWorkers;
+        }
+        allDone.notify_all();
+    }
+}
@@ -1,10 +1,27 @@
 #include <include/GameOfLife.h>
+#include <include/LifeFile.h>
+#include <include/BatchRunner.h>
+#include <include/Renderer.h>
+#include <include/RenderThread.h>
+#include <include/Checkpointer.h>
+#include <include/Distributed.h>
+#include <include/RuleSweep.h>
+#include <include/MappedGrid.h>
+#include <include/PatternCache.h>
+#include <include/History.h>
+#include <include/SimulationWorker.h>
+#include <memory>
+#include <include/HashLife.h>
+#include <include/InfinitePlane.h>
+#include <fstream>
 #include <iostream>
 #include <string>
 #include <cstring>
 #include <cstdlib>
+#include <cstdio>
 #include <chrono>
 #include <thread>
+#include <vector>
 
 // Функция для вывода исторической справки о Game of Life
 void printHistory() {
@@ -21,31 +38,153 @@ void printHistory() {
 }
 
 int main(int argc, char* argv[]) {
-    // Вывод исторической справки
-    printHistory();
-
     std::string inputFilename;   // Имя входного файла
     std::string outputFilename;  // Имя выходного файла
-    int numIterations = 0;       // Количество итераций
+    long long numIterations = 0; // Количество итераций
     int mode = 2;                // Режим работы программы: 2 - случайное состояние (по умолчанию)
 
+    int numThreads = 0;          // Количество потоков расчета (0 — не задано)
+    bool trackActivity = true;   // Пересчитывать только активные плитки поля
+    std::string engine = "grid"; // Движок расчета: grid (поле-тор), mapped (тор в файлах), infinite или hashlife
+    std::size_t hashlifeMemoryMb = 256; // Ограничение памяти кэша узлов Hashlife в мегабайтах
+    std::string batchManifest;   // Манифест пакетного режима
+    double maxFps = 2;           // Ограничение частоты кадров команды tick (0 — без ограничения)
+    std::string glyphsName = "ascii"; // Способ вывода клеток: ascii, half или braille
+    long long checkpointEvery = 0;    // Период контрольных точек в поколениях (0 — не сохранять)
+    int checkpointKeep = 3;           // Сколько последних контрольных точек хранить
+    std::string checkpointPrefix = "checkpoint"; // Префикс файлов контрольных точек
+    bool resume = false;              // Продолжить с последней контрольной точки
+    bool detectCycles = true;         // Останавливать расчет -i N при повторении состояния
+    std::string metricsFilename;      // Куда выгрузить метрики (.csv — по поколениям, иначе JSON)
+    int numProcesses = 0;             // Число процессов расчета -i N (0 — в текущем процессе)
+    std::string sweepSpec;            // Набор правил режима перебора: rules, all или список через запятую
+    int sweepSeeds = 8;               // Зерна 1..N случайных полей режима перебора
+    SweepOptions sweepOptions;        // Размер полей и предел поколений режима перебора
+    int mappedRows = 25;              // Размер поля движка mapped
+    int mappedCols = 50;
+    std::string mappedPrefix = "mapped"; // Префикс файлов поколений движка mapped
+    int blockSteps = 1;               // Поколений за один проход по полю при расчете -i N
+    int historyInterval = 0;          // Период ключевых кадров истории поколений (0 — не записывать)
+
+    // Параметры вида --name=value, не влияющие на выбор режима, разбираем отдельно
+    std::vector<char*> args;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--threads=", 10) == 0) {
+            numThreads = std::atoi(argv[i] + 10);
+        } else if (std::strcmp(argv[i], "--no-sparse") == 0) {
+            trackActivity = false;
+        } else if (std::strncmp(argv[i], "--engine=", 9) == 0) {
+            engine = argv[i] + 9;
+        } else if (std::strncmp(argv[i], "--hashlife-mem=", 15) == 0) {
+            hashlifeMemoryMb = std::strtoull(argv[i] + 15, nullptr, 10);
+        } else if (std::strncmp(argv[i], "--batch=", 8) == 0) {
+            batchManifest = argv[i] + 8;
+        } else if (std::strncmp(argv[i], "--fps=", 6) == 0) {
+            maxFps = std::atof(argv[i] + 6);
+        } else if (std::strncmp(argv[i], "--glyphs=", 9) == 0) {
+            glyphsName = argv[i] + 9;
+        } else if (std::strncmp(argv[i], "--checkpoint-every=", 19) == 0) {
+            checkpointEvery = std::atoll(argv[i] + 19);
+        } else if (std::strncmp(argv[i], "--checkpoint-keep=", 18) == 0) {
+            checkpointKeep = std::atoi(argv[i] + 18);
+        } else if (std::strncmp(argv[i], "--checkpoint-prefix=", 20) == 0) {
+            checkpointPrefix = argv[i] + 20;
+        } else if (std::strcmp(argv[i], "--resume") == 0) {
+            resume = true;
+        } else if (std::strncmp(argv[i], "--metrics=", 10) == 0) {
+            metricsFilename = argv[i] + 10;
+        } else if (std::strncmp(argv[i], "--processes=", 12) == 0) {
+            numProcesses = std::atoi(argv[i] + 12);
+        } else if (std::strncmp(argv[i], "--sweep=", 8) == 0) {
+            sweepSpec = argv[i] + 8;
+        } else if (std::strncmp(argv[i], "--seeds=", 8) == 0) {
+            sweepSeeds = std::atoi(argv[i] + 8);
+        } else if (std::strncmp(argv[i], "--generations=", 14) == 0) {
+            sweepOptions.generations = std::atoll(argv[i] + 14);
+        } else if (std::strncmp(argv[i], "--sweep-size=", 13) == 0) {
+            std::sscanf(argv[i] + 13, "%dx%d", &sweepOptions.rows, &sweepOptions.cols);
+        } else if (std::strncmp(argv[i], "--mapped-size=", 14) == 0) {
+            std::sscanf(argv[i] + 14, "%dx%d", &mappedRows, &mappedCols);
+        } else if (std::strncmp(argv[i], "--mapped-prefix=", 16) == 0) {
+            mappedPrefix = argv[i] + 16;
+        } else if (std::strncmp(argv[i], "--block-steps=", 14) == 0) {
+            blockSteps = std::max(1, std::atoi(argv[i] + 14));
+        } else if (std::strncmp(argv[i], "--history=", 10) == 0) {
+            historyInterval = std::max(0, std::atoi(argv[i] + 10));
+        } else if (std::strcmp(argv[i], "--no-cycle-check") == 0) {
+            detectCycles = false;
+        } else {
+            args.push_back(argv[i]);
+        }
+    }
+    const int argCount = static_cast<int>(args.size());
+
+    // Пакетный режим: без справки, командного цикла и вывода поля, по строке итогов на задание
+    if (!batchManifest.empty()) {
+        std::vector<BatchJob> jobs;
+        if (!readBatchManifest(batchManifest, jobs, std::cerr)) {
+            return 1;
+        }
+        // По умолчанию задания распределяются по всем ядрам
+        int batchThreads = numThreads > 0 ? numThreads : static_cast<int>(std::thread::hardware_concurrency());
+        auto start = std::chrono::steady_clock::now();
+        int failed = runBatch(jobs, batchThreads, std::cout);
+        std::cout << "Batch: " << jobs.size() << " jobs, " << failed << " failed, "
+                  << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() << " s"
+                  << std::endl;
+        return failed == 0 ? 0 : 1;
+    }
+
+    // Режим перебора правил: таблица итогов по каждому сочетанию правила и зерна
+    if (!sweepSpec.empty()) {
+        std::vector<RuleMasks> rules;
+        if (!sweepRules(sweepSpec, rules, std::cerr)) {
+            return 1;
+        }
+        if (sweepSeeds <= 0 || sweepOptions.rows <= 0 || sweepOptions.cols <= 0 || sweepOptions.generations < 0) {
+            std::cerr << "Error: Invalid sweep parameters" << std::endl;
+            return 1;
+        }
+        std::vector<unsigned> seeds;
+        for (int seed = 1; seed <= sweepSeeds; ++seed) {
+            seeds.push_back(static_cast<unsigned>(seed));
+        }
+        int sweepThreads = numThreads > 0 ? numThreads : static_cast<int>(std::thread::hardware_concurrency());
+        auto start = std::chrono::steady_clock::now();
+        std::vector<SweepRun> runs = runSweep(rules, seeds, sweepOptions, sweepThreads);
+        writeSweepTable(runs, std::cout);
+        std::cout << "Sweep: " << runs.size() << " runs, "
+                  << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() << " s"
+                  << std::endl;
+        return 0;
+    }
+
+    // Вывод исторической справки
+    printHistory();
+    std::cout << "Step kernel: " << activeKernel().name << std::endl;
+
+    // Шаблоны и правила читаются с диска один раз, дальше команды берут их из кэша
+    PatternCache& patterns = patternCache();
+    std::cout << "Templates: " << patterns.templateNames().size() << ", rules: " << patterns.rules().size()
+              << std::endl;
+
     // Разбор аргументов командной строки
-    if (argc > 1) {
-        inputFilename = argv[1];
-        if (argc == 2) {
+    if (argCount > 0) {
+        inputFilename = args[0];
+        if (argCount == 1) {
             mode = 1; // Только входной файл
         } else {
-            for (int i = 2; i < argc; ++i) {
-                if (std::strcmp(argv[i], "-i") == 0 && i + 1 < argc) {
-                    numIterations = std::atoi(argv[++i]);
-                } else if (std::strncmp(argv[i], "--iterations=", 13) == 0) {
-                    numIterations = std::atoi(argv[i] + 13);
-                } else if (std::strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
-                    outputFilename = argv[++i];
-                } else if (std::strncmp(argv[i], "--output=", 9) == 0) {
-                    outputFilename = argv[i] + 9;
+            for (int i = 1; i < argCount; ++i) {
+                if (std::strcmp(args[i], "-i") == 0 && i + 1 < argCount) {
+                    numIterations = std::atoll(args[++i]);
+                } else if (std::strncmp(args[i], "--iterations=", 13) == 0) {
+                    numIterations = std::atoll(args[i] + 13);
+                } else if (std::strcmp(args[i], "-o") == 0 && i + 1 < argCount) {
+                    outputFilename = args[++i];
+                } else if (std::strncmp(args[i], "--output=", 9) == 0) {
+                    outputFilename = args[i] + 9;
                 } else {
-                    outputFilename = argv[i];
+                    outputFilename = args[i];
                 }
             }
             if (!inputFilename.empty() && !outputFilename.empty() && numIterations > 0) {
@@ -54,39 +193,287 @@ int main(int argc, char* argv[]) {
         }
     }
 
+    if (engine != "grid" && engine != "mapped" && engine != "infinite" && engine != "hashlife") {
+        std::cerr << "Unknown engine '" << engine << "'! Use grid, mapped, infinite or hashlife." << std::endl;
+        return 1;
+    }
+
+    TerminalRenderer::Glyphs glyphs;
+    if (!TerminalRenderer::parseGlyphs(glyphsName, glyphs)) {
+        std::cerr << "Unknown glyphs '" << glyphsName << "'! Use ascii, half or braille." << std::endl;
+        return 1;
+    }
+    TerminalRenderer renderer(glyphs, maxFps);
+
     // Проверка входного файла, если он указан
-    if ((mode == 1 || mode == 3) && !(endsWith(inputFilename, ".lif") || endsWith(inputFilename, ".life"))) {
+    if ((mode == 1 || mode == 3) && !(endsWith(inputFilename, ".lif") || endsWith(inputFilename, ".life") ||
+                                          endsWith(inputFilename, ".rle") || endsWith(inputFilename, ".snap"))) {
         std::cerr << "Invalid input filename format!" << std::endl;
         return 1;
     }
 
     // Создаем объект игры с заданными размерами поля
     Game game("My Game of Life", 25, 50);
+    game.setThreads(numThreads > 0 ? numThreads : 1);
+    game.trackActivity = trackActivity;
+    game.blockSteps = blockSteps;
+    game.collectStats = GOL_METRICS; // Сводка поколений для метрик: население, рождения, смерти
+
+    // Выгрузка метрик: .csv — по строке на поколение, иначе JSON со временем фаз и счетчиками
+    auto writeMetrics = [](const std::string& filename) {
+        std::ofstream out(filename);
+        if (!out.is_open()) {
+            std::cerr << "Error: Unable to open metrics file '" << filename << "'" << std::endl;
+            return;
+        }
+        if (endsWith(filename, ".csv")) {
+            metrics().writeCsv(out);
+        } else {
+            metrics().writeJson(out);
+        }
+        std::cout << "Metrics saved to " << filename << std::endl;
+    };
+
+    // Последняя контрольная точка заменяет входной файл: поле, правило и номер поколения берутся из нее
+    std::string resumeFrom = resume ? Checkpointer::latest(checkpointPrefix) : std::string();
+    if (resume && resumeFrom.empty()) {
+        std::cerr << "No checkpoints with prefix '" << checkpointPrefix << "' found, starting from scratch" << std::endl;
+    }
+
+    const bool streamSnapshots = mode == 3 && engine == "grid" && numProcesses > 0 && resumeFrom.empty() &&
+                                 endsWith(inputFilename, ".snap") && endsWith(outputFilename, ".snap");
 
     // Инициализация игры в зависимости от режима
-    switch (mode) {
-        case 1:
-        case 3:
-            game.readFromFile(inputFilename);
-            break;
-        case 2:
-            game.generateRandomState();
-            break;
-        default:
-            std::cerr << "Invalid mode!" << std::endl;
+    if (!resumeFrom.empty() && engine == "grid") {
+        if (!game.readFromFile(resumeFrom)) {
             return 1;
+        }
+    } else {
+        switch (mode) {
+            case 1:
+            case 3:
+                // Движки бесконечной плоскости читают файл сами, без обрезки по полю.
+                // Правило из заголовка RLE или снимка применяется к игре: по нему движки и считают.
+                // Снимок в снимок при --processes считается по файлам, поле в память не загружается
+                if (streamSnapshots) {
+                    break;
+                }
+                if (mode == 1 || engine == "grid") {
+                    game.readFromFile(inputFilename);
+                } else {
+                    std::string fileRule;
+                    RuleMasks rule;
+                    if (readFileRule(inputFilename, fileRule) && !fileRule.empty()) {
+                        if (!parseRuleMasks(fileRule, rule)) {
+                            std::cerr << "Rule '" << fileRule << "' in '" << inputFilename
+                                      << "' is not supported by the " << engine << " engine!" << std::endl;
+                            return 1;
+                        }
+                        game.parseRules(formatRule(rule));
+                    }
+                }
+                break;
+            case 2:
+                game.generateRandomState();
+                break;
+            default:
+                std::cerr << "Invalid mode!" << std::endl;
+                return 1;
+        }
     }
 
+    // Контрольные точки пишутся фоновым потоком, расчет на время записи не останавливается
+    std::unique_ptr<Checkpointer> checkpointer;
+    if (checkpointEvery > 0) {
+        checkpointer = std::make_unique<Checkpointer>(checkpointPrefix, checkpointKeep);
+    }
+    // Контрольные точки — снимки .snap, а в них правило Larger than Life не сохраняется: для таких правил
+    // точки не пишутся (иначе --resume молча продолжил бы с другим правилом)
+    bool checkpointsRefused = false;
+    auto checkpoint = [&]() {
+        if (checkpointer && (game.curIteration - 1) % checkpointEvery == 0) {
+            if (!game.rangeRule.active()) {
+                checkpointer->submit(game.field, game.ruleMasks, static_cast<std::uint64_t>(game.curIteration));
+            } else if (!checkpointsRefused) {
+                checkpointsRefused = true;
+                std::cerr << "Checkpoints are not written for rule " << game.ruleString()
+                          << ": snapshots keep only B/S rules" << std::endl;
+            }
+        }
+    };
+
+    // История поколений для команды replay: ключевой кадр раз в --history поколений, между ними разности
+    History history(historyInterval);
+    auto recordHistory = [&]() {
+        if (historyInterval > 0) {
+            history.record(game.field, game.curIteration);
+        }
+    };
+    recordHistory();
+
     // Выполняем итерации, если указано
     if ((mode == 1 || mode == 3) && numIterations > 0) {
-        for (int i = 0; i < numIterations; ++i) {
-            game.calculateNextState();
+        // Остальные движки считают только правила B/S по маскам
+        if (engine != "grid" && game.rangeRule.active()) {
+            std::cerr << "Rule " << game.ruleString() << " is supported only by the grid engine!" << std::endl;
+            return 1;
         }
-        if (mode == 3) {
-            game.saveToFile(outputFilename);
+        if (engine == "hashlife") {
+            // Hashlife считает на бесконечной плоскости: файл читается заново без обрезки по полю,
+            // а в поле игры затем копируется только его окно
+            HashLife life(game.ruleMasks, hashlifeMemoryMb << 20);
+            life.readFromFile(inputFilename);
+            life.advance(static_cast<std::uint64_t>(numIterations));
+            life.copyToGrid(game.field);
+            std::cout << "Hashlife: generation " << life.generation() << ", population " << life.population()
+                      << ", nodes " << life.nodeCount() << ", garbage collections " << life.garbageCollections()
+                      << std::endl;
+            if (mode == 3) {
+                life.saveToFile(outputFilename, game.gameName);
+            }
+        } else if (engine == "mapped") {
+            // Поколения лежат в файлах <префикс>.0.snap и <префикс>.1.snap, в памяти — только несколько полос.
+            // Снимок .snap открывается целиком (размер, правило, поколение), остальные файлы читаются в поле
+            // размера --mapped-size
+            MappedGrid mapped;
+            mapped.setThreads(numThreads > 0 ? numThreads : 1);
+            bool opened = endsWith(inputFilename, ".snap")
+                              ? mapped.open(mappedPrefix, inputFilename)
+                              : mapped.create(mappedPrefix, mappedRows, mappedCols) && mapped.importCells(inputFilename);
+            if (opened) {
+                if (!endsWith(inputFilename, ".snap")) {
+                    mapped.setRule(game.ruleMasks);
+                }
+                mapped.advance(static_cast<std::uint64_t>(numIterations));
+                mapped.copyToGrid(game.field);
+                std::cout << "Mapped grid: generation " << mapped.generation() << ", population "
+                          << mapped.population() << ", file " << mapped.currentPath() << std::endl;
+                if (mode == 3) {
+                    mapped.save(outputFilename, game.gameName);
+                }
+            }
+        } else if (engine == "infinite") {
+            // Плитки бесконечной плоскости создаются по мере роста узора, края не замыкаются
+            InfinitePlane plane(game.ruleMasks);
+            plane.readFromFile(inputFilename);
+            plane.advance(static_cast<std::uint64_t>(numIterations));
+            plane.copyToGrid(game.field);
+            std::cout << "Infinite plane: generation " << plane.generation() << ", population " << plane.population()
+                      << ", tiles " << plane.tileCount() << ", memory " << plane.memoryBytes() << " bytes"
+                      << std::endl;
+            if (mode == 3) {
+                plane.saveToFile(outputFilename, game.gameName);
+            }
+        } else if (streamSnapshots) {
+            // Каждый процесс читает свою полосу из входного снимка и пишет ее в выходной
+            SnapshotHeader header;
+            if (!readSnapshotHeader(inputFilename, header)) {
+                return 1;
+            }
+            long long remaining = std::max(0LL, numIterations - (static_cast<long long>(header.generation) - 1));
+            if (!runDistributed(inputFilename, outputFilename, remaining, numProcesses)) {
+                return 1;
+            }
+            std::cout << "Processes: " << numProcesses << ", generation " << header.generation + remaining - 1
+                      << std::endl;
+            std::cout << "Game state saved to file '" << outputFilename << "'" << std::endl;
+            // Командному циклу нужно итоговое поле; процессы уже завершились, так что копия поля одна
+            if (!game.readFromFile(outputFilename)) {
+                return 1;
+            }
+        } else if (numProcesses > 0 && !game.rangeRule.active()) {
+            // Полосы поля считаются отдельными процессами; контрольные точки и поиск циклов
+            // требуют поля на каждом поколении и в этом режиме не работают.
+            // Правила Larger than Life считаются только в текущем процессе
+            long long remaining = numIterations - (game.curIteration - 1);
+            if (remaining > 0) {
+                if (!runDistributed(game.field, game.ruleMasks, remaining, numProcesses)) {
+                    return 1;
+                }
+                game.curIteration += remaining;
+                std::cout << "Processes: " << numProcesses << ", generation " << game.curIteration - 1 << std::endl;
+            }
+            if (mode == 3) {
+                game.saveToFile(outputFilename);
+            }
+        } else {
+            // -i задает итоговое число поколений: после --resume досчитываются только оставшиеся.
+            // Повторившееся состояние находится по хешу поля. Совпадение хеша только кандидат: поле
+            // запоминается и через период сравнивается с текущим целиком. Если совпало, полные периоды
+            // пропускаются и досчитывается только остаток, так что результат не меняется; если нет
+            // (коллизия хеша), история забывается и поиск продолжается.
+            // При --block-steps хеш проверяется раз в блок, и найденный период может быть кратен настоящему
+            CycleDetector cycles;
+            game.trackHash = detectCycles;
+            bool cycleFound = !detectCycles || cycles.record(game.stateHash(), game.curIteration);
+            Grid cycleField;             // Поле в поколении, где совпал хеш
+            long long cycleCheckAt = -1; // Поколение, в котором поле сверяется с cycleField
+            while (game.curIteration - 1 < numIterations) {
+                // Блоками по --block-steps поколений, но не дальше конца прогона, ближайшей контрольной
+                // точки и поколения сверки цикла
+                long long chunk = std::min<long long>(game.blockSteps, numIterations - (game.curIteration - 1));
+                if (checkpointer) {
+                    chunk = std::min(chunk, checkpointEvery - (game.curIteration - 1) % checkpointEvery);
+                }
+                if (cycleCheckAt >= 0) {
+                    chunk = std::min(chunk, cycleCheckAt - game.curIteration);
+                }
+                game.advance(chunk);
+                checkpoint();
+                recordHistory();
+                if (cycleCheckAt == game.curIteration) {
+                    cycleCheckAt = -1;
+                    if (game.field == cycleField) {
+                        cycleFound = true;
+                        long long period = cycles.period();
+                        std::cout << (period == 1 ? "Still life" : "Period " + std::to_string(period))
+                                  << " reached at iteration " << game.curIteration - period << std::endl;
+                        long long remaining = numIterations - (game.curIteration - 1);
+                        game.curIteration += remaining - remaining % period;
+                    } else {
+                        cycles.clear();
+                    }
+                } else if (!cycleFound && cycleCheckAt < 0 && cycles.record(game.stateHash(), game.curIteration)) {
+                    cycleField = game.field;
+                    cycleCheckAt = game.curIteration + cycles.period();
+                }
+            }
+            if (mode == 3) {
+                game.saveToFile(outputFilename);
+            }
+        }
+        if (!metricsFilename.empty()) {
+            writeMetrics(metricsFilename);
         }
     }
 
+    // Кадры команды tick выводит отдельный поток; его создает и публикует в него поток расчета.
+    // Пока он жив, renderer и std::cout принадлежат ему: любой другой вывод поля сначала
+    // останавливает его через stopTickDisplay (в потоке расчета, внутри call)
+    std::unique_ptr<RenderThread> tickDisplay;
+    long long tickUntil = 0; // Поколение, на котором tick показывает последний кадр
+    auto stopTickDisplay = [&]() {
+        if (tickDisplay) {
+            tickDisplay->finish();
+            tickDisplay.reset();
+        }
+    };
+
+    // Расчет идет в отдельном потоке: run и step не останавливают командный цикл, а команды,
+    // которые читают или меняют игру, выполняются в потоке расчета между поколениями (call).
+    // status и dump берут согласованный снимок поля и не ждут конца расчета
+    SimulationWorker worker(game, [&](Game&) {
+        checkpoint();
+        recordHistory();
+        if (tickDisplay) {
+            bool last = game.curIteration >= tickUntil;
+            tickDisplay->publish(game, last);
+            if (last) {
+                stopTickDisplay();
+            }
+        }
+    });
+
     // Основной цикл обработки пользовательских команд
     while (true) {
         std::string command;
@@ -95,9 +482,18 @@ int main(int argc, char* argv[]) {
 
         if (command == "dump") {
             std::cin >> outputFilename;
-            game.saveToFile(outputFilename);
-            std::cout << "Game state saved to " << outputFilename << std::endl;
+            const SimulationSnapshot& snapshot = worker.snapshot();
+            if (game.saveToFile(outputFilename, snapshot.field, snapshot.generation)) {
+                std::cout << "Game state saved to " << outputFilename << std::endl;
+            }
         } else if (command == "exit") {
+            worker.stop();
+            if (checkpointer) {
+                checkpointer->wait();
+            }
+            if (!metricsFilename.empty()) {
+                writeMetrics(metricsFilename);
+            }
             std::cout << "Thank you for exploring the Game of Life! Goodbye!" << std::endl;
             return 0;
         } else if (command == "help") {
@@ -105,45 +501,133 @@ int main(int argc, char* argv[]) {
                       << "  dump <filename>     - Save the current game state to the specified file.\n"
                       << "  exit                - Exit the program.\n"
                       << "  help                - Show this help message.\n"
-                      << "  tick <n=1>          - Calculate n iterations (default: 1) and display the game field.\n"
+                      << "  tick <n=1>          - Calculate n iterations (default: 1) in the background and display them.\n"
+                      << "  run                 - Calculate generations in the background until pause.\n"
+                      << "  pause               - Stop the background calculation.\n"
+                      << "  step <n=1>          - Calculate n generations in the background.\n"
+                      << "  status              - Show the generation, population and speed of the calculation.\n"
                       << "  random              - Load a new random template.\n"
                       << "  template <name>     - Load a predefined template (e.g., glider.txt, pulsar.txt).\n"
                       << "  loadrules <filename> - Load game rules from the specified file.\n"
-                      << "  randomrules         - Generate random game rules.\n";
+                      << "  randomrules         - Generate random game rules.\n"
+                      << "  stats [filename]    - Show timings and counters, or save them (.csv or .json).\n"
+                      << "  replay <from> [to]  - Show recorded generations from..to (run with --history=K).\n";
         } else if (command == "tick") {
             int ticks = 1;
             if (std::cin.peek() != '\n') { // Проверяем, есть ли дополнительный аргумент
                 std::cin >> ticks;
             }
-            // Выполняем итерации с задержкой
-            for (int i = 0; i < ticks; ++i) {
-                game.calculateNextState();
-                game.printState();  // Показываем текущее состояние после итерации
-
-                // Задержка в 500 миллисекунд (0.5 секунды) между итерациями
-                std::this_thread::sleep_for(std::chrono::milliseconds(500));
+            // Поколения считаются в фоне как step n, командный цикл их не ждет. Кадры выводит отдельный
+            // поток с ограничением частоты кадров: он показывает самое свежее поколение, последнее
+            // поколение показывается всегда. Первый кадр выводится целиком (экран сдвинулся вводом
+            // команды), дальше перерисовываются только изменившиеся строки
+            if (ticks > 0) {
+                worker.call([&](Game&) {
+                    stopTickDisplay();
+                    renderer.invalidate();
+                    tickDisplay = std::make_unique<RenderThread>(renderer, std::cout);
+                    // Последний кадр — после уже поставленных в очередь поколений и новых ticks
+                    tickUntil = game.curIteration + worker.status().pendingSteps + ticks;
+                });
+                worker.step(ticks);
             }
+        } else if (command == "run") {
+            worker.run();
+            std::cout << "Running in the background, type 'pause' to stop" << std::endl;
+        } else if (command == "pause") {
+            worker.pause();
+            // Прерванный tick больше не получит кадров: его поток вывода останавливается
+            worker.call([&](Game&) { stopTickDisplay(); });
+            std::cout << "Paused at generation " << worker.status().generation << std::endl;
+        } else if (command == "step") {
+            long long steps = 1;
+            if (std::cin.peek() != '\n') {
+                std::cin >> steps;
+            }
+            worker.step(steps);
+        } else if (command == "status") {
+            SimulationWorker::Status state = worker.status();
+            const SimulationSnapshot& snapshot = worker.snapshot();
+            std::cout << "Generation " << snapshot.generation << ", population " << snapshot.field.population()
+                      << ", " << state.generationsPerSecond << " generations/s, "
+                      << (state.running             ? std::string("running")
+                          : state.pendingSteps > 0 ? std::to_string(state.pendingSteps) + " generations left"
+                                                    : std::string("paused"))
+                      << std::endl;
         } else if (command == "random") {
-            game.generateRandomState();
-            game.printState();
+            worker.call([&](Game&) {
+                stopTickDisplay();
+                game.generateRandomState();
+                renderer.invalidate();
+                renderer.draw(game, std::cout);
+            });
         } else if (command == "template") {
             std::string templateName;
             std::cin >> templateName;
 
-            // Генерация случайных координат для начала шаблона
-            int startX = rand() % game.numCols;
-            int startY = rand() % game.numRows;
+            worker.call([&](Game&) {
+                // Генерация случайных координат для начала шаблона
+                int startX = rand() % game.numCols;
+                int startY = rand() % game.numRows;
 
-            // Загружаем шаблон, передавая его имя и сгенерированные координаты
-            game.loadTemplate(templateName, startX, startY);
+                // Загружаем шаблон, передавая его имя и сгенерированные координаты
+                game.loadTemplate(templateName, startX, startY);
 
-            game.printState();
+                stopTickDisplay();
+                renderer.invalidate();
+                renderer.draw(game, std::cout);
+            });
         } else if (command == "loadrules") {
             std::string rulesFilename;
             std::cin >> rulesFilename;
-            game.loadRulesFromFile(rulesFilename);
+            worker.call([&](Game&) { game.loadRulesFromFile(rulesFilename); });
         } else if (command == "randomrules") {
-            game.generateRandomRules();
+            worker.call([&](Game&) { game.generateRandomRules(); });
+        } else if (command == "stats") {
+            std::string metricsFile;
+            if (std::cin.peek() != '\n') {
+                std::cin >> metricsFile;
+            }
+            worker.call([&](Game&) {
+                if (metricsFile.empty()) {
+                    std::cout << "Metrics:\n";
+                    metrics().writeSummary(std::cout);
+                } else {
+                    writeMetrics(metricsFile);
+                }
+            });
+        } else if (command == "replay") {
+            long long from = 0;
+            std::cin >> from;
+            long long to = from;
+            if (std::cin.peek() != '\n') {
+                std::cin >> to;
+            }
+            // История пополняется потоком расчета, поэтому кадры показываются тоже в нем
+            worker.call([&](Game&) {
+                if (history.empty()) {
+                    std::cerr << "No history recorded! Start the program with --history=K." << std::endl;
+                    return;
+                }
+                std::cout << "History: generations " << history.firstGeneration() << ".."
+                          << history.lastGeneration() << ", " << history.keyframeCount() << " keyframes, "
+                          << history.memoryBytes() << " bytes (" << history.uncompressedBytes() << " as full grids)"
+                          << std::endl;
+                // Поле игры не меняется: кадры восстанавливаются во временное поле
+                Grid frame;
+                stopTickDisplay();
+                renderer.invalidate();
+                for (long long generation = from; generation <= to; ++generation) {
+                    if (!history.seek(generation, frame)) {
+                        std::cerr << "Generation " << generation << " is not recorded" << std::endl;
+                        break;
+                    }
+                    std::string header;
+                    TerminalRenderer::appendHeader(game, generation, header);
+                    renderer.waitForNextFrame();
+                    renderer.draw(frame, header, std::cout);
+                }
+            });
         } else {
             std::cerr << "Invalid command! Type 'help' for available commands." << std::endl;
         }
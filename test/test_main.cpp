@@ -1,7 +1,89 @@
 ﻿#include <gtest/gtest.h>
 #include "include/GameOfLife.h"
+#include "include/HashLife.h"
+#include "include/InfinitePlane.h"
+#include "include/BatchRunner.h"
+#include "include/Renderer.h"
+#include "include/LifeFile.h"
+#include "include/Checkpointer.h"
+#include "include/Distributed.h"
+#include "include/RuleSweep.h"
+#include "include/MappedGrid.h"
+#include "include/RenderThread.h"
+#include "include/PatternCache.h"
+#include "include/History.h"
+#include "include/RangeRule.h"
+#include "include/SimulationWorker.h"
+#include <thread>
+#include <sstream>
 #include <fstream>
 #include <string>
+#include <random>
+#include <atomic>
+#include <filesystem>
+#include <cstdlib>
+#include <new>
+
+// Счетчик выделений памяти через глобальный operator new. Заменены все формы new и delete
+// (одиночные, массивы, с размером, nothrow), чтобы любая пара new/delete шла через malloc/free.
+// free вызывается из невстраиваемой функции: иначе после встраивания delete компилятор видит free
+// для указателя из operator new и выдает -Wmismatched-new-delete
+static std::atomic<std::size_t> allocationCount{0};
+
+static void* countedAllocate(std::size_t size) noexcept {
+    ++allocationCount;
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+[[gnu::noinline]] static void countedFree(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void* operator new(std::size_t size) {
+    if (void* ptr = countedAllocate(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    if (void* ptr = countedAllocate(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAllocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAllocate(size);
+}
+
+void operator delete(void* ptr) noexcept {
+    countedFree(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    countedFree(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    countedFree(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+    countedFree(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+    countedFree(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+    countedFree(ptr);
+}
 
 // Тесты на функции endsWith и isInteger
 TEST(GameOfLifeTest, func_endsWithTest) {
@@ -36,6 +118,11 @@ TEST(GameOfLifeTest, ParseRulesTest) {
     game.parseRules("B3/S23");
     EXPECT_EQ(game.birthRules, std::vector<int>({3}));
     EXPECT_EQ(game.survivalRules, std::vector<int>({2, 3}));
+    EXPECT_EQ(game.ruleMasks.birth, 1u << 3);
+    EXPECT_EQ(game.ruleMasks.survival, (1u << 2) | (1u << 3));
+
+    game.parseRules("B36/S125");
+    EXPECT_TRUE(game.ruleMasks == ruleMasksFromString("B36/S125"));
 }
 
 // Тест загрузки шаблона из файла
@@ -49,8 +136,8 @@ TEST(GameOfLifeTest, LoadTemplateTest) {
 
     // Теперь файл существует, и можно его загрузить
     ASSERT_NO_THROW(game.loadTemplate("test_template.txt", 1, 1));
-    EXPECT_TRUE(game.field[2][2].isAlive);
-    EXPECT_FALSE(game.field[1][1].isAlive);
+    EXPECT_TRUE(game.field.get(2, 2));
+    EXPECT_FALSE(game.field.get(1, 1));
 
     // Удаляем тестовый файл
     std::remove("templates/test_template.txt");
@@ -67,9 +154,9 @@ TEST(GameOfLifeTest, LoadNonexistentTemplateTest) {
 // Тест на корректность подсчета соседей
 TEST(GameOfLifeTest, CountNeighborsTest) {
     Game game("Test Game", 5, 5);
-    game.field[1][1].isAlive = true;
-    game.field[1][2].isAlive = true;
-    game.field[2][1].isAlive = true;
+    game.field.set(1, 1, true);
+    game.field.set(1, 2, true);
+    game.field.set(2, 1, true);
     EXPECT_EQ(game.countNeighbors(2, 2), 3);
     EXPECT_EQ(game.countNeighbors(1, 1), 2);
 }
@@ -77,75 +164,1257 @@ TEST(GameOfLifeTest, CountNeighborsTest) {
 // Тест на выполнение следующего шага игры
 TEST(GameOfLifeTest, CalculateNextStateTest) {
     Game game("Test Game", 3, 3);
-    game.field[0][1].isAlive = true;
-    game.field[1][1].isAlive = true;
-    game.field[2][1].isAlive = true;
+    game.field.set(0, 1, true);
+    game.field.set(1, 1, true);
+    game.field.set(2, 1, true);
 
     game.calculateNextState();
 
-    EXPECT_TRUE(game.field[1][0].isAlive); 
-    EXPECT_TRUE(game.field[1][1].isAlive);  
-    EXPECT_TRUE(game.field[1][2].isAlive);  
-    EXPECT_TRUE(game.field[0][1].isAlive);  
-    EXPECT_TRUE(game.field[2][1].isAlive);  
+    EXPECT_TRUE(game.field.get(1, 0)); 
+    EXPECT_TRUE(game.field.get(1, 1));  
+    EXPECT_TRUE(game.field.get(1, 2));  
+    EXPECT_TRUE(game.field.get(0, 1));  
+    EXPECT_TRUE(game.field.get(2, 1));  
 }
 
 
 // Тест стабильного паттерна (блок)
 TEST(GameOfLifeTest, StablePatternTest) {
     Game game("Test Game", 4, 4);
-    game.field[1][1].isAlive = true;
-    game.field[1][2].isAlive = true;
-    game.field[2][1].isAlive = true;
-    game.field[2][2].isAlive = true;
+    game.field.set(1, 1, true);
+    game.field.set(1, 2, true);
+    game.field.set(2, 1, true);
+    game.field.set(2, 2, true);
 
     game.calculateNextState();
 
-    EXPECT_TRUE(game.field[1][1].isAlive);
-    EXPECT_TRUE(game.field[1][2].isAlive);
-    EXPECT_TRUE(game.field[2][1].isAlive);
-    EXPECT_TRUE(game.field[2][2].isAlive);
+    EXPECT_TRUE(game.field.get(1, 1));
+    EXPECT_TRUE(game.field.get(1, 2));
+    EXPECT_TRUE(game.field.get(2, 1));
+    EXPECT_TRUE(game.field.get(2, 2));
 }
 
 // Тест осциллирующего паттерна (мигалка)
 TEST(GameOfLifeTest, OscillatingPatternTest) {
     Game game("Test Game", 5, 5);
-    game.field[2][1].isAlive = true;
-    game.field[2][2].isAlive = true;
-    game.field[2][3].isAlive = true;
+    game.field.set(2, 1, true);
+    game.field.set(2, 2, true);
+    game.field.set(2, 3, true);
 
     game.calculateNextState();
 
-    EXPECT_TRUE(game.field[1][2].isAlive);
-    EXPECT_TRUE(game.field[2][2].isAlive);
-    EXPECT_TRUE(game.field[3][2].isAlive);
+    EXPECT_TRUE(game.field.get(1, 2));
+    EXPECT_TRUE(game.field.get(2, 2));
+    EXPECT_TRUE(game.field.get(3, 2));
 
     game.calculateNextState();
 
-    EXPECT_TRUE(game.field[2][1].isAlive);
-    EXPECT_TRUE(game.field[2][2].isAlive);
-    EXPECT_TRUE(game.field[2][3].isAlive);
+    EXPECT_TRUE(game.field.get(2, 1));
+    EXPECT_TRUE(game.field.get(2, 2));
+    EXPECT_TRUE(game.field.get(2, 3));
 }
 
 // Тест сохранения и загрузки из файла
 TEST(GameOfLifeTest, SaveAndLoadFileTest) {
     Game game("Test Game", 5, 5);
-    game.field[1][1].isAlive = true;
-    game.field[2][2].isAlive = true;
+    game.field.set(1, 1, true);
+    game.field.set(2, 2, true);
 
     game.saveToFile("test_save.life");
 
     Game loadedGame("Loaded Game", 5, 5);
     loadedGame.readFromFile("test_save.life");
 
-    EXPECT_EQ(loadedGame.field[1][1].isAlive, true);
-    EXPECT_EQ(loadedGame.field[2][2].isAlive, true);
+    EXPECT_EQ(loadedGame.field.get(1, 1), true);
+    EXPECT_EQ(loadedGame.field.get(2, 2), true);
     EXPECT_EQ(loadedGame.numRows, 5);
     EXPECT_EQ(loadedGame.numCols, 5);
 
     std::remove("test_save.life");
 }
 
+// Тест упаковки битового поля
+TEST(GridTest, PackedLayoutTest) {
+    Grid grid(3, 70);
+    EXPECT_EQ(grid.wordsPerRow(), 2);
+    EXPECT_EQ(grid.memoryBytes(), 3 * 2 * sizeof(Grid::Word));
+
+    grid.set(1, 0, true);
+    grid.set(1, 64, true);
+    grid.set(2, 69, true);
+    EXPECT_TRUE(grid.get(1, 0));
+    EXPECT_TRUE(grid.get(1, 64));
+    EXPECT_TRUE(grid.get(2, 69));
+    EXPECT_FALSE(grid.get(0, 0));
+    EXPECT_EQ(grid.rowData(1)[1], Grid::Word(1));
+    EXPECT_EQ(grid.tailMask(), (Grid::Word(1) << 6) - 1);
+    EXPECT_EQ(grid.population(), 3u);
+
+    grid.set(1, 64, false);
+    EXPECT_FALSE(grid.get(1, 64));
+    grid.clear();
+    EXPECT_EQ(grid.population(), 0u);
+}
+
+// Заполнить поле случайными клетками с фиксированным зерном
+static void fillRandom(Game& game, unsigned seed, double density = 0.35) {
+    std::mt19937 gen(seed);
+    std::bernoulli_distribution alive(density);
+    for (int row = 0; row < game.numRows; ++row) {
+        for (int col = 0; col < game.numCols; ++col) {
+            game.field.set(row, col, alive(gen));
+        }
+    }
+}
+
+// Сравнение битово-параллельного шага с поклеточным расчетом для разных размеров и правил
+TEST(GameOfLifeTest, BitParallelMatchesReferenceTest) {
+    const std::vector<std::pair<int, int>> sizes = {{1, 1}, {2, 3}, {1, 64}, {3, 65}, {17, 130}, {40, 200}};
+    const std::vector<std::string> rules = {"B3/S23", "B36/S23", "B2/S23", "B3/S12", "B4/S23", "B0/S8", "B012345678/S"};
+
+    unsigned seed = 1;
+    for (const auto& size : sizes) {
+        for (const auto& rule : rules) {
+            Game fast("Fast", size.first, size.second);
+            fast.parseRules(rule);
+            fillRandom(fast, seed++);
+            Game reference = fast;
+
+            for (int generation = 0; generation < 5; ++generation) {
+                fast.calculateNextState();
+                reference.calculateNextStateReference();
+                ASSERT_TRUE(fast.field == reference.field)
+                    << rule << " " << size.first << "x" << size.second << " generation " << generation;
+            }
+        }
+    }
+}
+
+// Все поддерживаемые процессором ядра должны давать одинаковый результат
+TEST(GameOfLifeTest, VectorKernelsMatchScalarTest) {
+    const std::vector<std::pair<int, int>> sizes = {{5, 64}, {9, 300}, {33, 1000}, {4, 1024}};
+    unsigned seed = 100;
+    for (const auto& size : sizes) {
+        Game scalar("Scalar", size.first, size.second);
+        scalar.parseRules("B36/S23");
+        scalar.kernel = &availableKernels().front();
+        fillRandom(scalar, seed++);
+
+        for (const KernelInfo& kernel : availableKernels()) {
+            Game vector = scalar;
+            vector.kernel = &kernel;
+            Game expected = scalar;
+            for (int generation = 0; generation < 4; ++generation) {
+                vector.calculateNextState();
+                expected.calculateNextState();
+                ASSERT_TRUE(vector.field == expected.field) << kernel.name << " generation " << generation;
+            }
+        }
+    }
+}
+
+// Многопоточный расчет полосами должен совпадать с однопоточным бит в бит
+TEST(GameOfLifeTest, MultithreadedMatchesSingleThreadedTest) {
+    Game single("Single", 97, 300);
+    fillRandom(single, 7);
+    Game multi = single;
+    multi.setThreads(4);
+
+    for (int generation = 0; generation < 20; ++generation) {
+        single.calculateNextState();
+        multi.calculateNextState();
+        ASSERT_TRUE(single.field == multi.field) << "generation " << generation;
+    }
+}
+
+// Пул потоков выполняет каждую задачу ровно один раз при многократных запусках
+TEST(ThreadPoolTest, ParallelForRunsEveryTaskOnceTest) {
+    ThreadPool pool(4);
+    EXPECT_EQ(pool.size(), 4);
+
+    std::vector<int> hits(37, 0);
+    for (int round = 0; round < 100; ++round) {
+        pool.parallelFor(static_cast<int>(hits.size()), [&](int index) { ++hits[index]; });
+    }
+    for (int count : hits) {
+        EXPECT_EQ(count, 100);
+    }
+}
+
+// После создания игры шаги не должны выделять память (в том числе в многопоточном режиме)
+TEST(GameOfLifeTest, SteppingDoesNotAllocateTest) {
+    for (int threads : {1, 3}) {
+        Game game("No Alloc", 120, 500);
+        game.setThreads(threads);
+        fillRandom(game, 11);
+
+        std::size_t before = allocationCount.load();
+        for (int generation = 0; generation < 50; ++generation) {
+            game.calculateNextState();
+        }
+        EXPECT_EQ(allocationCount.load() - before, 0u) << "threads " << threads;
+    }
+}
+
+// Специализированные под правило ядра совпадают с общим ядром по маскам
+TEST(GameOfLifeTest, FixedRuleKernelsMatchGenericTest) {
+    Grid current(13, 400);
+    std::mt19937 gen(5);
+    for (int row = 0; row < current.rows(); ++row) {
+        for (int col = 0; col < current.cols(); ++col) {
+            current.set(row, col, gen() % 3 == 0);
+        }
+    }
+
+    for (const KernelInfo& kernel : availableKernels()) {
+        for (const RuleMasks& rule : kFixedRules) {
+            RowKernel fixed = kernel.findFixed(rule);
+            ASSERT_NE(fixed, nullptr) << kernel.name;
+            EXPECT_EQ(kernel.select(rule), fixed);
+
+            Grid expected(current.rows(), current.cols());
+            Grid actual(current.rows(), current.cols());
+            for (int row = 1; row + 1 < current.rows(); ++row) {
+                kernel.step(current.rowData(row - 1), current.rowData(row), current.rowData(row + 1),
+                            expected.rowData(row), current.cols(), 0, current.wordsPerRow(), rule);
+                fixed(current.rowData(row - 1), current.rowData(row), current.rowData(row + 1),
+                      actual.rowData(row), current.cols(), 0, current.wordsPerRow(), rule);
+            }
+            EXPECT_TRUE(expected == actual) << kernel.name << " B" << rule.birth << " S" << rule.survival;
+        }
+        // Для остальных правил используется общее ядро
+        EXPECT_EQ(kernel.select(ruleMasksFromString("B1357/S1357")), kernel.step);
+    }
+}
+
+// Hashlife совпадает с расчетом на торе, пока узор не дошел до краев поля
+TEST(HashLifeTest, MatchesGridEngineTest) {
+    Game game("Grid", 300, 300);
+    game.loadTemplate("glider_gun.txt", 40, 40);
+    game.loadTemplate("pulsar.txt", 150, 20);
+
+    HashLife life(game.ruleMasks);
+    life.loadFromGrid(game.field);
+    EXPECT_EQ(life.population(), game.field.population());
+
+    for (int generation = 0; generation < 200; ++generation) {
+        game.calculateNextState();
+    }
+    life.advance(200);
+    EXPECT_EQ(life.generation(), 200u);
+
+    Grid window(game.numRows, game.numCols);
+    life.copyToGrid(window);
+    EXPECT_TRUE(window == game.field);
+    EXPECT_EQ(life.population(), game.field.population());
+}
+
+// Прыжок на 2^k поколений совпадает с продвижением по одному, а сборка мусора не портит поле
+TEST(HashLifeTest, PowerOfTwoStepAndGarbageCollectionTest) {
+    HashLife fast(ruleMasksFromString("B3/S23"));
+    HashLife slow(ruleMasksFromString("B3/S23"), 64 << 10);
+    for (HashLife* life : {&fast, &slow}) {
+        // R-пентамино с отрицательными координатами
+        life->setCell(-1000, -999, true);
+        life->setCell(-999, -999, true);
+        life->setCell(-1001, -998, true);
+        life->setCell(-1000, -998, true);
+        life->setCell(-1000, -997, true);
+    }
+
+    fast.advancePowerOfTwo(9);
+    for (int i = 0; i < 512; ++i) {
+        slow.advance(1);
+    }
+    EXPECT_EQ(fast.generation(), slow.generation());
+    EXPECT_EQ(fast.population(), slow.population());
+    EXPECT_GT(slow.garbageCollections(), 0u);
+
+    std::vector<std::pair<std::int64_t, std::int64_t>> fastCells, slowCells;
+    fast.forEachCell([&](std::int64_t x, std::int64_t y) { fastCells.emplace_back(x, y); });
+    slow.forEachCell([&](std::int64_t x, std::int64_t y) { slowCells.emplace_back(x, y); });
+    std::sort(fastCells.begin(), fastCells.end());
+    std::sort(slowCells.begin(), slowCells.end());
+    EXPECT_EQ(fastCells, slowCells);
+}
+
+// Один большой прыжок при малом бюджете собирает мусор внутри шага и не выходит за предел узлов
+TEST(HashLifeTest, MemoryLimitWithinStepTest) {
+    HashLife fast(ruleMasksFromString("B3/S23"));
+    HashLife limited(ruleMasksFromString("B3/S23"), 64 << 10);
+    for (HashLife* life : {&fast, &limited}) {
+        life->setCell(0, 1, true);
+        life->setCell(1, 1, true);
+        life->setCell(-1, 2, true);
+        life->setCell(0, 2, true);
+        life->setCell(0, 3, true);
+        life->advancePowerOfTwo(10);
+    }
+    EXPECT_EQ(fast.generation(), limited.generation());
+    EXPECT_EQ(fast.population(), limited.population());
+    EXPECT_GT(limited.garbageCollections(), 0u);
+    EXPECT_LE(limited.peakNodeCount(), limited.maxNodes() + 64);
+    EXPECT_GT(fast.peakNodeCount(), limited.maxNodes());
+}
+
+// Пересчет только активных плиток дает тот же результат, что и полный, и зависит от активности
+TEST(GameOfLifeTest, SparseTilesMatchFullStepTest) {
+    Game sparse("Sparse", 300, 520);
+    sparse.loadTemplate("glider.txt", 10, 10);
+    sparse.loadTemplate("blinker.txt", 200, 150);
+    Game full = sparse;
+    full.trackActivity = false;
+
+    for (int generation = 0; generation < 300; ++generation) {
+        sparse.calculateNextState();
+        full.calculateNextState();
+        ASSERT_TRUE(sparse.field == full.field) << "generation " << generation;
+
+        // Снаружи поменяли поле — история изменений должна сброситься
+        if (generation == 150) {
+            sparse.field.set(250, 400, true);
+            sparse.field.set(250, 401, true);
+            sparse.field.set(250, 402, true);
+            full.field = sparse.field;
+        }
+    }
+
+    // Глайдер и две мигалки занимают лишь несколько плиток из 5x9
+    EXPECT_EQ(sparse.activity.tileCount(), 45u);
+    EXPECT_LE(sparse.activeTiles, 3u * 9u);
+    EXPECT_EQ(full.activeTiles, 45u);
+
+    // Смена правила тоже сбрасывает историю
+    sparse.parseRules("B36/S23");
+    full.parseRules("B36/S23");
+    sparse.calculateNextState();
+    full.calculateNextState();
+    EXPECT_TRUE(sparse.field == full.field);
+    EXPECT_EQ(sparse.activeTiles, 45u);
+}
+
+// Бесконечная плоскость совпадает с тором, пока узор не дошел до краев, и с Hashlife — всегда
+TEST(InfinitePlaneTest, MatchesGridAndHashLifeTest) {
+    Game game("Grid", 200, 200);
+    game.loadTemplate("glider_gun.txt", 20, 20);
+
+    InfinitePlane plane(game.ruleMasks);
+    plane.loadFromGrid(game.field);
+    HashLife life(game.ruleMasks);
+    life.loadFromGrid(game.field);
+
+    for (int generation = 0; generation < 100; ++generation) {
+        game.calculateNextState();
+    }
+    plane.advance(100);
+    Grid window(game.numRows, game.numCols);
+    plane.copyToGrid(window);
+    EXPECT_TRUE(window == game.field);
+
+    // Дальше глайдеры уходят за пределы любого тора этого размера
+    plane.advance(900);
+    life.advance(1000);
+    EXPECT_EQ(plane.population(), life.population());
+    std::size_t cells = 0;
+    plane.forEachCell([&](std::int64_t x, std::int64_t y) {
+        EXPECT_TRUE(life.getCell(x, y)) << x << " " << y;
+        ++cells;
+    });
+    EXPECT_EQ(cells, plane.population());
+}
+
+// Плитки создаются и освобождаются вслед за узором, отрицательные координаты поддерживаются
+TEST(InfinitePlaneTest, TilesFollowPatternTest) {
+    InfinitePlane plane(ruleMasksFromString("B3/S23"));
+    // Глайдер, летящий на северо-запад, далеко от начала координат
+    const std::int64_t base = -(std::int64_t(1) << 40);
+    plane.setCell(base + 0, base + 0, true);
+    plane.setCell(base + 1, base + 0, true);
+    plane.setCell(base + 2, base + 0, true);
+    plane.setCell(base + 0, base + 1, true);
+    plane.setCell(base + 1, base + 2, true);
+    EXPECT_TRUE(plane.getCell(base + 1, base + 2));
+    EXPECT_FALSE(plane.getCell(base + 2, base + 2));
+
+    for (int generation = 0; generation < 2000; ++generation) {
+        plane.step();
+        EXPECT_LE(plane.tileCount(), 4u);
+    }
+    EXPECT_EQ(plane.population(), 5u);
+    // За 2000 поколений глайдер смещается на 500 клеток по диагонали
+    EXPECT_TRUE(plane.getCell(base - 500 + 1, base - 500 + 0));
+
+    plane.setCell(0, 0, true);
+    EXPECT_EQ(plane.population(), 6u);
+    plane.setCell(0, 0, false);
+    EXPECT_EQ(plane.population(), 5u);
+}
+
+// Пакетный режим: разбор манифеста и те же результаты, что и при расчете по одному
+TEST(BatchRunnerTest, ManifestJobsMatchSerialRunTest) {
+    {
+        std::ofstream input("test_batch_input.life");
+        input << "#Life 1.06\n1 0\n2 1\n0 2\n1 2\n2 2\n";
+        std::ofstream manifest("test_batch.txt");
+        manifest << "# input rule iterations output [rows cols]\n"
+                 << "\n"
+                 << "test_batch_input.life B3/S23 40 test_batch_out1.life 20 30\n"
+                 << "test_batch_input.life B36/S23 7 test_batch_out2.life\n"
+                 << "test_batch_missing.life - 1 -\n";
+        std::ofstream broken("test_batch_broken.txt");
+        broken << "test_batch_input.life B9/S23 10 out.life\n"
+               << "test_batch_input.life B3/S23 ten out.life\n";
+    }
+
+    std::vector<BatchJob> jobs;
+    std::ostringstream errors;
+    ASSERT_TRUE(readBatchManifest("test_batch.txt", jobs, errors)) << errors.str();
+    ASSERT_EQ(jobs.size(), 3u);
+    EXPECT_EQ(jobs[0].rows, 20);
+    EXPECT_EQ(jobs[0].cols, 30);
+    EXPECT_EQ(jobs[0].line, 3);
+    EXPECT_EQ(jobs[1].rows, 25);
+    EXPECT_EQ(jobs[1].iterations, 7);
+
+    std::vector<BatchJob> brokenJobs;
+    EXPECT_FALSE(readBatchManifest("test_batch_broken.txt", brokenJobs, errors));
+    EXPECT_TRUE(brokenJobs.empty());
+
+    std::ostringstream summary;
+    EXPECT_EQ(runBatch(jobs, 3, summary), 1);
+    std::string text = summary.str();
+    EXPECT_EQ(std::count(text.begin(), text.end(), '\n'), 3);
+    EXPECT_NE(text.find("[3/3] test_batch_missing.life: error"), std::string::npos);
+
+    for (int job = 0; job < 2; ++job) {
+        Game expected("Expected", jobs[job].rows, jobs[job].cols);
+        expected.verbose = false;
+        expected.parseRules(jobs[job].rule);
+        expected.readFromFile("test_batch_input.life");
+        for (long long i = 0; i < jobs[job].iterations; ++i) {
+            expected.calculateNextStateReference();
+        }
+        Game written("Written", jobs[job].rows, jobs[job].cols);
+        written.verbose = false;
+        ASSERT_TRUE(written.readFromFile(jobs[job].output));
+        EXPECT_EQ(written.field, expected.field) << "job " << job;
+        std::remove(jobs[job].output.c_str());
+    }
+    std::remove("test_batch_input.life");
+    std::remove("test_batch.txt");
+    std::remove("test_batch_broken.txt");
+}
+
+// Правило из манифеста заменяет правило из заголовка RLE, а "-" оставляет его
+TEST(BatchRunnerTest, ManifestRuleOverridesFileRuleTest) {
+    Game pattern("Pattern", 20, 20);
+    pattern.verbose = false;
+    fillRandom(pattern, 11, 0.4);
+    ASSERT_TRUE(writeRle("test_batch_rule.rle", pattern.field, "Pattern", ruleMasksFromString("B36/S23")));
+
+    for (const char* rule : {"B3/S23", "-"}) {
+        BatchJob job;
+        job.input = "test_batch_rule.rle";
+        job.rule = rule;
+        job.iterations = 12;
+        job.output = "test_batch_rule_out.life";
+        job.rows = 20;
+        job.cols = 20;
+        ASSERT_TRUE(runBatchJob(job).ok) << rule;
+
+        Game expected("Expected", 20, 20);
+        expected.verbose = false;
+        expected.field = pattern.field;
+        expected.parseRules(job.rule == "-" ? "B36/S23" : job.rule);
+        for (long long i = 0; i < job.iterations; ++i) {
+            expected.calculateNextState();
+        }
+        Game written("Written", 20, 20);
+        written.verbose = false;
+        ASSERT_TRUE(written.readFromFile(job.output));
+        EXPECT_EQ(written.field, expected.field) << rule;
+    }
+    std::remove("test_batch_rule.rle");
+    std::remove("test_batch_rule_out.life");
+}
+
+// У снимка .snap размер поля берется из файла, и в итогах задания указан именно он
+TEST(BatchRunnerTest, SnapshotJobReportsLoadedSizeTest) {
+    Game pattern("Pattern", 40, 70);
+    pattern.verbose = false;
+    fillRandom(pattern, 17, 0.3);
+    ASSERT_TRUE(writeSnapshot("test_batch_size.snap", pattern.field, pattern.ruleMasks, 1));
+
+    BatchJob job;
+    job.input = "test_batch_size.snap";
+    job.rule = "-";
+    job.iterations = 5;
+    job.output = "-";
+    BatchResult result = runBatchJob(job);
+    ASSERT_TRUE(result.ok) << result.error;
+    EXPECT_EQ(result.rows, 40);
+    EXPECT_EQ(result.cols, 70);
+    std::remove("test_batch_size.snap");
+}
+
+// Вывод поля: полный первый кадр, затем только изменившиеся строки
+TEST(RendererTest, RedrawsOnlyChangedRowsTest) {
+    Game game("Render", 8, 6);
+    game.field.set(1, 2, true);
+    game.field.set(5, 0, true);
+
+    TerminalRenderer renderer;
+    std::string frame = renderer.renderFrame(game);
+    EXPECT_EQ(frame.rfind("\x1b[H\x1b[2J", 0), 0u);
+    EXPECT_NE(frame.find("│  X   │\n"), std::string::npos);
+    EXPECT_NE(frame.find("│X     │\n"), std::string::npos);
+    EXPECT_EQ(renderer.redrawnRows(), 8u);
+
+    // Без изменений выводится только перевод курсора под рамку
+    frame = renderer.renderFrame(game);
+    EXPECT_EQ(renderer.redrawnRows(), 0u);
+    EXPECT_EQ(frame, "\x1b[15;1H");
+
+    game.field.set(5, 0, false);
+    game.field.set(5, 5, true);
+    frame = renderer.renderFrame(game);
+    EXPECT_EQ(renderer.redrawnRows(), 1u);
+    EXPECT_NE(frame.find("\x1b[11;1H│     X│"), std::string::npos);
+
+    renderer.invalidate();
+    renderer.renderFrame(game);
+    EXPECT_EQ(renderer.redrawnRows(), 8u);
+}
+
+// Полублоки упаковывают 2 клетки в символ, шрифт Брайля — 8
+TEST(RendererTest, PackedGlyphsTest) {
+    Game game("Render", 4, 4);
+    game.field.set(0, 0, true);
+    game.field.set(1, 1, true);
+    game.field.set(0, 2, true);
+    game.field.set(1, 2, true);
+    game.field.set(3, 3, true);
+
+    TerminalRenderer half(TerminalRenderer::Glyphs::HalfBlock);
+    std::string frame = half.renderFrame(game);
+    EXPECT_NE(frame.find("│▀▄█ │\n│   ▄│\n"), std::string::npos);
+
+    TerminalRenderer braille(TerminalRenderer::Glyphs::Braille);
+    frame = braille.renderFrame(game);
+    // Точки 1 и 5 — U+2811, точки 1, 2 и 8 — U+2883
+    EXPECT_NE(frame.find("│⠑⢃│\n"), std::string::npos);
+    EXPECT_EQ(braille.redrawnRows(), 1u);
+
+    TerminalRenderer::Glyphs glyphs;
+    EXPECT_TRUE(TerminalRenderer::parseGlyphs("braille", glyphs));
+    EXPECT_EQ(glyphs, TerminalRenderer::Glyphs::Braille);
+    EXPECT_FALSE(TerminalRenderer::parseGlyphs("sixel", glyphs));
+}
+
+// RLE: чтение стандартной записи узора и сохранение поля без потери положения клеток
+TEST(LifeFileTest, RleRoundTripTest) {
+    {
+        std::ofstream rle("test_glider.rle");
+        rle << "#C glider\nx = 3, y = 3, rule = B36/S23\nbo$2bo$3o!\n";
+    }
+    Game game("RLE", 10, 12);
+    game.verbose = false;
+    ASSERT_TRUE(game.readFromFile("test_glider.rle"));
+    EXPECT_EQ(game.field.population(), 5u);
+    EXPECT_TRUE(game.field.get(0, 1));
+    EXPECT_TRUE(game.field.get(1, 2));
+    EXPECT_TRUE(game.field.get(2, 0));
+    EXPECT_TRUE(game.field.get(2, 2));
+    EXPECT_EQ(game.ruleMasks, ruleMasksFromString("B36/S23"));
+    // Правило из заголовка без чтения клеток (для движков, которые читают файл сами)
+    std::string fileRule;
+    ASSERT_TRUE(readFileRule("test_glider.rle", fileRule));
+    EXPECT_EQ(fileRule, "B36/S23");
+
+    Game dense("Dense", 70, 150);
+    dense.verbose = false;
+    fillRandom(dense, 7, 0.4);
+    dense.field.set(69, 149, true);
+    ASSERT_TRUE(dense.saveToFile("test_dense.rle"));
+    Game loaded("Loaded", 70, 150);
+    loaded.verbose = false;
+    ASSERT_TRUE(loaded.readFromFile("test_dense.rle"));
+    EXPECT_EQ(loaded.field, dense.field);
+
+    // Длина строк RLE не превышает 70 символов
+    std::ifstream written("test_dense.rle");
+    std::string line;
+    while (std::getline(written, line)) {
+        EXPECT_LE(line.size(), 70u);
+    }
+    std::remove("test_glider.rle");
+    std::remove("test_dense.rle");
+}
+
+// Двоичный снимок восстанавливает размер, правило, номер поколения и клетки; порча обнаруживается
+TEST(LifeFileTest, SnapshotRoundTripTest) {
+    Game game("Snapshot", 33, 130);
+    game.verbose = false;
+    game.parseRules("B36/S23");
+    fillRandom(game, 11);
+    for (int i = 0; i < 5; ++i) {
+        game.calculateNextState();
+    }
+    EXPECT_EQ(game.curIteration, 6);
+    ASSERT_TRUE(game.saveToFile("test_state.snap"));
+    std::string fileRule;
+    ASSERT_TRUE(readFileRule("test_state.snap", fileRule));
+    EXPECT_EQ(fileRule, "B36/S23");
+
+    Game restored("Restored", 5, 5);
+    restored.verbose = false;
+    ASSERT_TRUE(restored.readFromFile("test_state.snap"));
+    EXPECT_EQ(restored.numRows, 33);
+    EXPECT_EQ(restored.numCols, 130);
+    EXPECT_EQ(restored.field, game.field);
+    EXPECT_EQ(restored.ruleMasks, game.ruleMasks);
+    EXPECT_EQ(restored.curIteration, 6);
+
+    game.calculateNextState();
+    restored.calculateNextState();
+    EXPECT_EQ(restored.field, game.field);
+
+    // Испорченное слово поля не проходит проверку контрольной суммы, поле при этом не меняется
+    {
+        std::fstream file("test_state.snap", std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(40 + 8 * 10);
+        file.put('\x5a');
+    }
+    Grid before = restored.field;
+    EXPECT_FALSE(restored.readFromFile("test_state.snap"));
+    EXPECT_EQ(restored.field, before);
+
+    // Заголовок, которому не хватает длины файла, отвергается до выделения памяти под поле
+    ASSERT_TRUE(game.saveToFile("test_state.snap"));
+    std::filesystem::resize_file("test_state.snap", 40 + 8 * 10);
+    SnapshotHeader header;
+    EXPECT_FALSE(readSnapshotHeader("test_state.snap", header));
+    EXPECT_FALSE(restored.readFromFile("test_state.snap"));
+    EXPECT_EQ(restored.field, before);
+    std::remove("test_state.snap");
+}
+
+// Контрольные точки пишутся в фоне, хранятся только последние и восстанавливают игру целиком
+TEST(CheckpointerTest, RotationAndResumeTest) {
+    const std::string prefix = "test_checkpoint";
+    for (const auto& file : Checkpointer::list(prefix)) {
+        std::remove(file.second.c_str());
+    }
+
+    Game game("Checkpoint", 40, 90);
+    game.verbose = false;
+    game.parseRules("B36/S23");
+    fillRandom(game, 21);
+    Grid atFifteen;
+    {
+        Checkpointer checkpointer(prefix, 2);
+        for (int i = 0; i < 20; ++i) {
+            game.calculateNextState();
+            if ((game.curIteration - 1) % 5 == 0) {
+                checkpointer.submit(game.field, game.ruleMasks, game.curIteration);
+                checkpointer.wait();
+            }
+            if (game.curIteration == 16) {
+                atFifteen = game.field;
+            }
+        }
+        EXPECT_EQ(checkpointer.writtenCount(), 4u);
+        EXPECT_EQ(checkpointer.droppedCount(), 0u);
+    }
+
+    auto files = Checkpointer::list(prefix);
+    ASSERT_EQ(files.size(), 2u);
+    EXPECT_EQ(files[0].first, 16u);
+    EXPECT_EQ(files[1].first, 21u);
+    EXPECT_EQ(Checkpointer::latest(prefix), files[1].second);
+
+    Game resumed("Resumed", 5, 5);
+    resumed.verbose = false;
+    ASSERT_TRUE(resumed.readFromFile(files[0].second));
+    EXPECT_EQ(resumed.field, atFifteen);
+    EXPECT_EQ(resumed.ruleMasks, game.ruleMasks);
+    for (int i = 0; i < 5; ++i) {
+        resumed.calculateNextState();
+    }
+    EXPECT_EQ(resumed.curIteration, game.curIteration);
+    EXPECT_EQ(resumed.field, game.field);
+
+    // Новый запуск продолжает ротацию с уже записанными точками; деструктор дожидается записи
+    {
+        Checkpointer checkpointer(prefix, 2);
+        checkpointer.submit(game.field, game.ruleMasks, 30);
+    }
+    files = Checkpointer::list(prefix);
+    ASSERT_EQ(files.size(), 2u);
+    EXPECT_EQ(files[0].first, 21u);
+    EXPECT_EQ(files[1].first, 30u);
+    for (const auto& file : files) {
+        std::remove(file.second.c_str());
+    }
+}
+
+// Хеш поля, обновляемый по изменившимся словам, совпадает с полным пересчетом
+TEST(CycleDetectorTest, IncrementalHashMatchesFullHashTest) {
+    Game game("Hash", 150, 200);
+    game.trackHash = true;
+    fillRandom(game, 5, 0.3);
+    std::uint64_t initial = game.stateHash();
+    EXPECT_EQ(initial, gridHash(game.field));
+
+    for (int i = 0; i < 60; ++i) {
+        game.calculateNextState();
+        EXPECT_EQ(game.fieldHash, gridHash(game.field)) << "generation " << i;
+        EXPECT_EQ(game.stateHash(), gridHash(game.field));
+        if (i == 30) {
+            // Изменение поля снаружи: хеш пересчитывается целиком
+            game.field.set(10, 10, !game.field.get(10, 10));
+            EXPECT_EQ(game.stateHash(), gridHash(game.field));
+        }
+    }
+
+    Game empty("Empty", 64, 64);
+    EXPECT_EQ(empty.stateHash(), 0u);
+}
+
+// Обнаружение натюрморта, осциллятора и ограниченная история
+TEST(CycleDetectorTest, DetectsPeriodsTest) {
+    Game game("Blinker", 20, 20);
+    game.trackHash = true;
+    game.field.set(5, 4, true);
+    game.field.set(5, 5, true);
+    game.field.set(5, 6, true);
+
+    CycleDetector cycles;
+    EXPECT_FALSE(cycles.record(game.stateHash(), game.curIteration));
+    game.calculateNextState();
+    EXPECT_FALSE(cycles.record(game.stateHash(), game.curIteration));
+    game.calculateNextState();
+    ASSERT_TRUE(cycles.record(game.stateHash(), game.curIteration));
+    EXPECT_EQ(cycles.period(), 2);
+    EXPECT_EQ(cycles.cycleStart(), 1);
+
+    // Блок — натюрморт с периодом 1
+    Game block("Block", 10, 10);
+    block.trackHash = true;
+    block.field.set(2, 2, true);
+    block.field.set(2, 3, true);
+    block.field.set(3, 2, true);
+    block.field.set(3, 3, true);
+    cycles.clear();
+    EXPECT_FALSE(cycles.record(block.stateHash(), 1));
+    block.calculateNextState();
+    ASSERT_TRUE(cycles.record(block.stateHash(), 2));
+    EXPECT_EQ(cycles.period(), 1);
+
+    // Периоды длиннее истории не находятся, более короткие находятся при любом заполнении таблицы
+    CycleDetector shortHistory(8);
+    for (long long generation = 0; generation < 1000; ++generation) {
+        EXPECT_FALSE(shortHistory.record(static_cast<std::uint64_t>(generation % 20) * 0x9E3779B97F4A7C15ull,
+                                         generation));
+    }
+    for (long long generation = 0; generation < 1000; ++generation) {
+        bool found = shortHistory.record(static_cast<std::uint64_t>(generation % 7 + 100), 1000 + generation);
+        EXPECT_EQ(found, generation >= 7) << generation;
+    }
+}
+
+// Сводка поколения (население, рождения, смерти) совпадает с прямым подсчетом и попадает в метрики,
+// в том числе для правила Larger than Life
+TEST(MetricsTest, GenerationStatsMatchFieldTest) {
+    for (const char* rule : {"B3/S23", "R2,C0,M1,S5..12,B6..9,NM"}) {
+        for (bool sparse : {true, false}) {
+            Game game("Stats", 100, 150);
+            game.parseRules(rule);
+            game.trackActivity = sparse;
+            game.collectStats = true;
+            fillRandom(game, 17, 0.3);
+            metrics().reset();
+
+            for (int generation = 0; generation < 30; ++generation) {
+                Grid before = game.field;
+                game.calculateNextState();
+                std::uint64_t births = 0, deaths = 0;
+                for (int row = 0; row < game.numRows; ++row) {
+                    for (int col = 0; col < game.numCols; ++col) {
+                        births += !before.get(row, col) && game.field.get(row, col);
+                        deaths += before.get(row, col) && !game.field.get(row, col);
+                    }
+                }
+                EXPECT_EQ(game.population, game.field.population());
+                EXPECT_EQ(game.births, births);
+                EXPECT_EQ(game.deaths, deaths);
+                EXPECT_EQ(game.fieldHash, gridHash(game.field));
+            }
+
+#if GOL_METRICS
+            ASSERT_EQ(metrics().generationCount(), 30u);
+            EXPECT_EQ(metrics().generation(29).iteration, game.curIteration);
+            EXPECT_EQ(metrics().generation(29).population, game.population);
+            EXPECT_EQ(metrics().phase(Phase::Step).count, 30u);
+            EXPECT_GT(metrics().cellsPerSecond(), 0.0);
+
+            std::ostringstream csv;
+            metrics().writeCsv(csv);
+            std::string text = csv.str();
+            EXPECT_EQ(text.rfind("iteration,population,births,deaths,step_ns\n", 0), 0u);
+            EXPECT_EQ(std::count(text.begin(), text.end(), '\n'), 31);
+#endif
+        }
+    }
+}
+
+// Расчет полосами в нескольких процессах совпадает с расчетом на торе в одном процессе,
+// в том числе при одной строке на процесс и ширине, не кратной 64
+TEST(DistributedTest, MatchesSingleProcessTest) {
+    for (int workers : {1, 2, 3, 7}) {
+        Game reference("Reference", 7 * 3, 131);
+        fillRandom(reference, 40 + workers, 0.3);
+        Grid grid = reference.field;
+        for (int generation = 0; generation < 25; ++generation) {
+            reference.calculateNextState();
+        }
+        ASSERT_TRUE(runDistributed(grid, reference.ruleMasks, 25, workers));
+        EXPECT_TRUE(grid == reference.field) << workers;
+    }
+
+    Game single("Single", 4, 70);
+    fillRandom(single, 5, 0.5);
+    Grid grid = single.field;
+    single.calculateNextState();
+    ASSERT_TRUE(runDistributed(grid, single.ruleMasks, 1, 4));
+    EXPECT_TRUE(grid == single.field);
+    EXPECT_FALSE(runDistributed(grid, single.ruleMasks, 1, 5));
+}
+
+// Снимок в снимок: процессы читают и пишут только свои полосы, итог совпадает с расчетом в Game
+TEST(DistributedTest, SnapshotToSnapshotTest) {
+    Game reference("Reference", 50, 130);
+    fillRandom(reference, 77, 0.3);
+    reference.parseRules("B36/S23");
+    ASSERT_TRUE(writeSnapshot("test_distributed_in.snap", reference.field, reference.ruleMasks, 5));
+    for (int generation = 0; generation < 30; ++generation) {
+        reference.calculateNextState();
+    }
+
+    ASSERT_TRUE(runDistributed("test_distributed_in.snap", "test_distributed_out.snap", 30, 3));
+    Grid result;
+    RuleMasks rule;
+    std::uint64_t generation = 0;
+    ASSERT_TRUE(readSnapshot("test_distributed_out.snap", result, rule, generation));
+    EXPECT_TRUE(result == reference.field);
+    EXPECT_EQ(rule, reference.ruleMasks);
+    EXPECT_EQ(generation, 35u);
+
+    // Выход не может совпадать со входом, а при ошибке выходной файл не остается
+    EXPECT_FALSE(runDistributed("test_distributed_in.snap", "test_distributed_in.snap", 1, 2));
+    EXPECT_FALSE(runDistributed("test_distributed_in.snap", "test_distributed_out.snap", 1, 51));
+    std::remove("test_distributed_in.snap");
+    EXPECT_FALSE(runDistributed("test_distributed_in.snap", "test_distributed_out.snap", 1, 2));
+    std::remove("test_distributed_out.snap");
+}
+
+// Итоги перебора совпадают с полным расчетом в Game: досрочная остановка по циклу
+// или вымиранию не меняет население на последнем поколении
+TEST(RuleSweepTest, MatchesFullRunTest) {
+    std::vector<RuleMasks> rules;
+    std::ostringstream errors;
+    ASSERT_TRUE(sweepRules("B3/S23,B36/S23,B/S,B2/S", rules, errors));
+    ASSERT_EQ(rules.size(), 4u);
+    EXPECT_FALSE(sweepRules("B3/S23,X", rules, errors));
+    ASSERT_TRUE(sweepRules("all", rules, errors));
+    EXPECT_EQ(rules.size(), 512u * 512u);
+    ASSERT_TRUE(sweepRules("B3/S23,B36/S23,B/S,B2/S", rules, errors));
+
+    SweepOptions options;
+    options.rows = 20;
+    options.cols = 70;
+    options.generations = 300;
+    std::vector<unsigned> seeds = {1, 2, 3};
+    std::vector<SweepRun> runs = runSweep(rules, seeds, options, 4);
+    ASSERT_EQ(runs.size(), 12u);
+    std::vector<SweepRun> serial = runSweep(rules, seeds, options, 1);
+    for (std::size_t i = 0; i < runs.size(); ++i) {
+        EXPECT_EQ(runs[i].population, serial[i].population);
+        EXPECT_EQ(runs[i].period, serial[i].period);
+    }
+
+    for (const SweepRun& run : runs) {
+        Game game("Sweep", options.rows, options.cols);
+        game.ruleMasks = run.rule;
+        fillSoup(game.field, run.seed, options.density);
+        long long extinction = -1;
+        for (long long generation = 1; generation <= options.generations; ++generation) {
+            game.calculateNextState();
+            if (extinction < 0 && game.field.population() == 0) {
+                extinction = generation;
+            }
+        }
+        EXPECT_EQ(run.population, game.field.population()) << formatRule(run.rule) << " seed " << run.seed;
+        EXPECT_EQ(run.extinction, extinction) << formatRule(run.rule) << " seed " << run.seed;
+    }
+    // Без рождений и выживания поле вымирает на первом шаге
+    EXPECT_EQ(runs[6].extinction, 1);
+    // Стандартное правило на маленьком поле за 300 поколений приходит к циклу
+    EXPECT_GT(runs[0].period, 0);
+
+    std::ostringstream table;
+    writeSweepTable(runs, table);
+    std::string text = table.str();
+    EXPECT_EQ(std::count(text.begin(), text.end(), '\n'), 13);
+    EXPECT_NE(text.find("B36/S23"), std::string::npos);
+
+    // При B0 пустое поле не вымерло: оно чередуется с полностью заполненным с периодом 2
+    ASSERT_TRUE(sweepRules("B0/S", rules, errors));
+    options.generations = 101;
+    std::vector<SweepRun> flips = runSweep(rules, {5}, options, 1);
+    Game flip("Flip", options.rows, options.cols);
+    flip.ruleMasks = rules[0];
+    fillSoup(flip.field, 5, options.density);
+    for (long long generation = 1; generation <= options.generations; ++generation) {
+        flip.calculateNextState();
+    }
+    EXPECT_EQ(flips[0].extinction, -1);
+    EXPECT_EQ(flips[0].period, 2);
+    EXPECT_EQ(flips[0].population, flip.field.population());
+}
+
+// Поле в отображенных файлах считается полосами так же, как поле в памяти; файл поколения —
+// готовый снимок, по которому можно продолжить расчет
+TEST(MappedGridTest, MatchesInMemoryFieldTest) {
+    Game reference("Mapped", 90, 130);
+    fillRandom(reference, 23, 0.3);
+
+    MappedGrid mapped;
+    mapped.setBandRows(7);
+    mapped.setThreads(3);
+    ASSERT_TRUE(mapped.create("test_mapped", reference.numRows, reference.numCols));
+    for (int row = 0; row < reference.numRows; ++row) {
+        for (int col = 0; col < reference.numCols; ++col) {
+            mapped.set(row, col, reference.field.get(row, col));
+        }
+    }
+
+    for (int generation = 0; generation < 20; ++generation) {
+        reference.calculateNextState();
+    }
+    mapped.advance(20);
+    EXPECT_EQ(mapped.generation(), 20u);
+    EXPECT_EQ(mapped.population(), reference.field.population());
+
+    Grid copy(reference.numRows, reference.numCols);
+    mapped.copyToGrid(copy);
+    EXPECT_TRUE(copy == reference.field);
+
+    ASSERT_TRUE(mapped.save("test_mapped_out.snap", "Mapped"));
+    Grid loaded;
+    RuleMasks rule;
+    std::uint64_t generation = 0;
+    ASSERT_TRUE(readSnapshot(mapped.currentPath(), loaded, rule, generation));
+    EXPECT_TRUE(loaded == reference.field);
+    EXPECT_EQ(generation, 20u);
+
+    MappedGrid resumed;
+    ASSERT_TRUE(resumed.open("test_mapped_resumed", "test_mapped_out.snap"));
+    EXPECT_EQ(resumed.generation(), 20u);
+    resumed.advance(5);
+    for (int i = 0; i < 5; ++i) {
+        reference.calculateNextState();
+    }
+    resumed.copyToGrid(copy);
+    EXPECT_TRUE(copy == reference.field);
+
+    for (const char* file : {"test_mapped.0.snap", "test_mapped.1.snap", "test_mapped_out.snap",
+                             "test_mapped_resumed.0.snap", "test_mapped_resumed.1.snap"}) {
+        std::remove(file);
+    }
+}
+
+// Расчет блоками по k поколений совпадает с пошаговым: и когда поле делится на много полос,
+// и когда запас полосы больше самого поля (строки берутся с замыканием)
+TEST(GameOfLifeTest, TemporalBlockingMatchesStepping) {
+    struct Case {
+        int rows;
+        int cols;
+        int threads;
+    };
+    for (Case sizes : {Case{300, 64 * 512, 1}, Case{300, 64 * 512 + 17, 3}, Case{5, 70, 1}}) {
+        for (int steps : {2, 3, 8}) {
+            Game reference("Reference", sizes.rows, sizes.cols);
+            fillRandom(reference, 70 + steps, 0.3);
+            Game blocked("Blocked", sizes.rows, sizes.cols);
+            blocked.field = reference.field;
+            blocked.blockSteps = steps;
+            blocked.setThreads(sizes.threads);
+
+            for (int generation = 0; generation < 19; ++generation) {
+                reference.calculateNextState();
+            }
+            blocked.advance(19);
+            EXPECT_TRUE(blocked.field == reference.field) << sizes.rows << "x" << sizes.cols << " k=" << steps;
+            EXPECT_EQ(blocked.curIteration, reference.curIteration);
+
+            // После блока пошаговый расчет с отслеживанием плиток продолжается верно
+            reference.calculateNextState();
+            blocked.calculateNextState();
+            EXPECT_TRUE(blocked.field == reference.field);
+        }
+    }
+}
+
+// Тройной буфер отдает читателю самое свежее значение; значения не идут назад и последнее не теряется
+TEST(RenderThreadTest, TripleBufferDeliversLatestTest) {
+    TripleBuffer<int> buffer;
+    EXPECT_FALSE(buffer.consume());
+    for (int value : {1, 2, 3}) {
+        buffer.writeSlot() = value;
+        buffer.publish();
+    }
+    ASSERT_TRUE(buffer.consume());
+    EXPECT_EQ(buffer.readSlot(), 3);
+    EXPECT_FALSE(buffer.consume());
+
+    TripleBuffer<long long> shared;
+    constexpr long long kLast = 200000;
+    std::thread writer([&] {
+        for (long long value = 4; value <= kLast; ++value) {
+            shared.writeSlot() = value;
+            shared.publish();
+        }
+    });
+    long long previous = 0;
+    while (previous != kLast) {
+        if (shared.consume()) {
+            EXPECT_GT(shared.readSlot(), previous);
+            previous = shared.readSlot();
+        }
+    }
+    writer.join();
+}
+
+// Поток вывода показывает последнее поколение и пропускает промежуточные, когда не успевает
+TEST(RenderThreadTest, ShowsFinalGenerationTest) {
+    Game game("Display", 20, 40);
+    fillRandom(game, 31, 0.4);
+    TerminalRenderer renderer(TerminalRenderer::Glyphs::Ascii, 50);
+    std::ostringstream out;
+    RenderThread display(renderer, out);
+    constexpr int kTicks = 300;
+    for (int i = 0; i < kTicks; ++i) {
+        game.calculateNextState();
+        display.publish(game, i + 1 == kTicks);
+    }
+    display.finish();
+
+    EXPECT_GE(display.shownFrames(), 1u);
+    EXPECT_LE(display.shownFrames(), display.publishedFrames());
+    EXPECT_LT(display.publishedFrames(), static_cast<std::size_t>(kTicks));
+
+    // Последний показанный кадр — итоговое поколение: повторный кадр по игре ничего не перерисовывает
+    renderer.renderFrame(game);
+    EXPECT_EQ(renderer.redrawnRows(), 0u);
+    EXPECT_NE(out.str().find(std::to_string(game.curIteration)), std::string::npos);
+}
+
+// Шаблон накладывается словами с замыканием краев так же, как поклеточно по модулю размера поля,
+// в том числе через границу слова и при отрицательных координатах; кэш знает каталоги шаблонов и правил
+TEST(PatternCacheTest, WrappedBlitMatchesCellwiseTest) {
+    const Grid* gun = patternCache().findTemplate("glider_gun.txt");
+    ASSERT_NE(gun, nullptr);
+    EXPECT_EQ(gun, patternCache().findTemplate("glider_gun.txt"));
+    EXPECT_EQ(patternCache().findTemplate("nonexistent.txt"), nullptr);
+    EXPECT_NE(std::find(patternCache().templateNames().begin(), patternCache().templateNames().end(), "glider.txt"),
+              patternCache().templateNames().end());
+    std::string rule;
+    EXPECT_TRUE(patternCache().findRule("explosion.txt", rule));
+    EXPECT_EQ(rule, "B3/S12");
+
+    const Grid wide = parseTemplate(".O" + std::string(68, '.') + "O\nOO\n\n" + std::string(70, '.') + "OO");
+    struct Case {
+        int rows;
+        int cols;
+        int startRow;
+        int startCol;
+    };
+    for (const Grid* pattern : {gun, &wide}) {
+        for (Case c : {Case{30, 70, 25, 60}, Case{30, 70, -3, -5}, Case{8, 20, 5, 17}, Case{40, 130, 10, 100}}) {
+            Grid grid(c.rows, c.cols);
+            grid.set(0, 0, true);
+            Grid expected = grid;
+            blitPattern(grid, *pattern, c.startRow, c.startCol);
+            for (int row = 0; row < pattern->rows(); ++row) {
+                for (int col = 0; col < pattern->cols(); ++col) {
+                    if (pattern->get(row, col)) {
+                        expected.set(((c.startRow + row) % c.rows + c.rows) % c.rows,
+                                     ((c.startCol + col) % c.cols + c.cols) % c.cols, true);
+                    }
+                }
+            }
+            EXPECT_TRUE(grid == expected) << c.rows << "x" << c.cols << " at " << c.startRow << "," << c.startCol;
+        }
+    }
+}
+
+// Переход к любому записанному поколению истории дает то же поле, что и пошаговый расчет,
+// а история ружья Госпера занимает намного меньше памяти, чем все поколения целиком
+TEST(HistoryTest, SeekMatchesSteppingTest) {
+    Game game("History", 64, 200);
+    game.loadTemplate("glider_gun.txt", 5, 5);
+    History history(16);
+    std::vector<Grid> expected;
+    for (int generation = 1; generation <= 300; ++generation) {
+        history.record(game.field, generation);
+        expected.push_back(game.field);
+        game.calculateNextState();
+    }
+    EXPECT_EQ(history.firstGeneration(), 1);
+    EXPECT_EQ(history.lastGeneration(), 300);
+    EXPECT_EQ(history.keyframeCount(), 19u);
+    EXPECT_LT(history.memoryBytes() * 8, history.uncompressedBytes());
+
+    Grid frame;
+    for (int generation : {300, 1, 16, 17, 18, 150, 299, 33}) {
+        ASSERT_TRUE(history.seek(generation, frame));
+        EXPECT_TRUE(frame == expected[generation - 1]) << "generation " << generation;
+    }
+    EXPECT_FALSE(history.seek(0, frame));
+    EXPECT_FALSE(history.seek(301, frame));
+
+    // Пропуск поколений начинает новый ключевой кадр, пропущенных поколений в истории нет
+    history.record(game.field, 310);
+    EXPECT_FALSE(history.seek(305, frame));
+    ASSERT_TRUE(history.seek(310, frame));
+    EXPECT_TRUE(frame == game.field);
+
+    // Запись более раннего поколения начинает историю заново
+    history.record(expected[0], 1);
+    EXPECT_EQ(history.generationCount(), 1u);
+    EXPECT_FALSE(history.seek(2, frame));
+}
+
+// Разбор правил Larger than Life: запись Golly, ошибки и обратное преобразование в строку
+TEST(RangeRuleTest, ParseTest) {
+    RangeRule rule;
+    ASSERT_TRUE(parseRangeRule("R5,C0,M1,S34..58,B34..45,NM", rule));
+    EXPECT_EQ(rule.range, 5);
+    EXPECT_TRUE(rule.countCenter);
+    EXPECT_EQ(rule.neighborhood, RangeRule::Neighborhood::Moore);
+    EXPECT_EQ(rule.surviveMin, 34);
+    EXPECT_EQ(rule.birthMax, 45);
+    EXPECT_EQ(rule.cellCount(), 121);
+    EXPECT_EQ(formatRangeRule(rule), "R5,C0,M1,S34..58,B34..45,NM");
+
+    ASSERT_TRUE(parseRangeRule("R3,C2,M0,S2..6,B5,NN", rule));
+    EXPECT_EQ(rule.neighborhood, RangeRule::Neighborhood::VonNeumann);
+    EXPECT_EQ(rule.birthMin, 5);
+    EXPECT_EQ(rule.birthMax, 5);
+    EXPECT_EQ(rule.cellCount(), 24);
+
+    for (const char* bad : {"B3/S23", "R0,C0,M0,S1..2,B1..2", "R2,C3,M0,S1..2,B1..2", "R1,C0,M0,S2..3",
+                            "R1,C0,M0,S3..2,B3..3", "R1,C0,M0,S2..9,B3..3", "R1,C0,M0,S2..3,B3..3,NX"}) {
+        EXPECT_FALSE(parseRangeRule(bad, rule)) << bad;
+    }
+
+    Game game("Range", 10, 10);
+    game.parseRules("R2,C0,M0,S3..5,B4..4,NM");
+    EXPECT_TRUE(game.rangeRule.active());
+    EXPECT_EQ(game.survivalRules, std::vector<int>({3, 4, 5}));
+    EXPECT_EQ(game.ruleString(), "R2,C0,M0,S3..5,B4..4,NM");
+    // Снимок хранит правило масками B/S, поэтому правило Larger than Life в .snap не сохраняется
+    game.verbose = false;
+    EXPECT_FALSE(game.saveToFile("test_range.snap"));
+    EXPECT_FALSE(std::ifstream("test_range.snap").is_open());
+    game.parseRules("B36/S23");
+    EXPECT_FALSE(game.rangeRule.active());
+    EXPECT_EQ(game.ruleString(), "B36/S23");
+}
+
+// Скользящие суммы совпадают с поклеточным подсчетом окрестности для квадрата и ромба,
+// в том числе когда окрестность больше поля, и при расчете в несколько потоков
+TEST(RangeRuleTest, SlidingWindowMatchesReferenceTest) {
+    const std::vector<std::string> rules = {
+        "R1,C0,M0,S2..3,B3..3,NM", "R5,C0,M1,S34..58,B34..45,NM", "R3,C0,M0,S6..14,B8..12,NN",
+        "R7,C0,M1,S20..60,B25..40,NN", "R4,C0,M0,S10..30,B12..20,NM"};
+    const std::vector<std::pair<int, int>> sizes = {{40, 130}, {7, 9}, {70, 64}};
+    unsigned seed = 1;
+    for (const std::string& rule : rules) {
+        for (auto [rows, cols] : sizes) {
+            for (int threads : {1, 3}) {
+                Game fast("Range", rows, cols);
+                fast.parseRules(rule);
+                fast.setThreads(threads);
+                fillRandom(fast, seed++, 0.4);
+                Game reference = fast;
+                for (int step = 0; step < 4; ++step) {
+                    fast.calculateNextState();
+                    reference.calculateNextStateReference();
+                    ASSERT_TRUE(fast.field == reference.field)
+                        << rule << " " << rows << "x" << cols << " threads " << threads << " step " << step;
+                }
+            }
+        }
+    }
+}
+
+// Фоновый расчет: step досчитывает ровно N поколений, снимки во время run согласованы
+// (совпадают с пошаговым расчетом до своего поколения), pause останавливает расчет
+TEST(SimulationWorkerTest, StepRunAndSnapshotTest) {
+    Game game("Worker", 30, 70);
+    fillRandom(game, 31);
+    Game reference = game;
+    std::atomic<long long> generations{0};
+
+    SimulationWorker worker(game, [&](Game&) { ++generations; });
+    worker.step(40);
+    worker.step(10);
+    worker.waitIdle();
+    EXPECT_EQ(worker.status().generation, 51);
+    EXPECT_EQ(generations.load(), 50);
+    for (int i = 0; i < 50; ++i) {
+        reference.calculateNextState();
+    }
+    EXPECT_TRUE(worker.snapshot().field == reference.field);
+
+    worker.run();
+    for (int check = 0; check < 3; ++check) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        const SimulationSnapshot& snapshot = worker.snapshot();
+        ASSERT_GE(snapshot.generation, reference.curIteration);
+        while (reference.curIteration < snapshot.generation) {
+            reference.calculateNextState();
+        }
+        EXPECT_TRUE(snapshot.field == reference.field) << "generation " << snapshot.generation;
+        EXPECT_TRUE(worker.status().running);
+    }
+
+    // call выполняется между поколениями и видит игру целиком
+    long long seen = 0;
+    worker.call([&](Game& running) { seen = running.curIteration; });
+    EXPECT_GT(seen, 51);
+
+    worker.pause();
+    SimulationWorker::Status status = worker.status();
+    EXPECT_FALSE(status.running);
+    EXPECT_EQ(status.pendingSteps, 0);
+    EXPECT_GT(status.generationsPerSecond, 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    EXPECT_EQ(worker.status().generation, status.generation);
+
+    worker.stop();
+    EXPECT_EQ(game.curIteration, status.generation);
+    EXPECT_EQ(generations.load(), status.generation - 1);
+
+    // Снимки во время расчета забирали буфер прошлого поколения, а поле при этом считалось верно
+    while (reference.curIteration < game.curIteration) {
+        reference.calculateNextState();
+    }
+    EXPECT_TRUE(game.field == reference.field);
+}
+
 int main(int argc, char* argv[]) {
     testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();